@@ -0,0 +1,271 @@
+#include <stdlib.h>
+#include <limits.h>
+#include "anytime.h"
+#include "grafo.h"
+#include "memoria.h"
+
+/* Estratégia de resolução com prazo (anytime): uma solução viável é obtida imediatamente e
+ * melhorada até o prazo, acompanhada de um limitante superior para o valor ótimo.
+ *
+ * A solução inicial é uma torre gulosa: a caixa de melhor razão valor/altura (toda caixa é
+ * empilhável sobre si mesma) é repetida enquanto couber e o restante da altura é preenchido,
+ * sobre ela, pelas caixas empilháveis de maior valor que ainda couberem.
+ *
+ * Em seguida, a programação dinâmica iterativa calcula as linhas k = 1, 2, ... da matriz de
+ * soluções ótimas até o prazo. Com as linhas até k calculadas, para cada caixa b obtém-se uma
+ * pilha formada por c cópias de b (o menor c tal que a altura restante h - c·a(b) não exceda k)
+ * com a melhor pilha da linha h - c·a(b) cuja base é empilhável sobre b. A melhor dessas pilhas
+ * e a torre gulosa é a solução retornada; quando k chega a h, ela é ótima.
+ *
+ * Limitante superior: seja r* a melhor razão valor/altura e A a maior altura de caixa. Em uma
+ * pilha de altura até h, o trecho superior de altura até k (retirando-se caixas da base enquanto
+ * a altura exceder k) tem altura maior do que k - A e valor de no máximo g(k), o maior valor da
+ * linha k; o trecho inferior tem altura menor do que h - k + A e valor de no máximo r* vezes essa
+ * altura. Assim, o ótimo não excede min(r*·h, g(k) + r*·(h - k + A - 1)).
+ */
+
+
+/* Constrói a torre gulosa descrita no início do arquivo. O vetor pilha deve ter capacidade para
+ * h / (menor altura de caixa) + 1 caixas; a base da torre é a primeira posição.
+ *
+ * Retorna o valor da torre e o seu tamanho (parâmetro tam, passado por referência).
+ *
+ * Complexidade: O(n(h / a_min + 1))
+ */
+int torre_gulosa(problema p, int* pilha, int* tam)
+{
+    int i, b = -1, topo, escolhida, restante = p->h, valor = 0; // Variáveis auxiliares.
+
+    *tam = 0;
+
+    // Caixa de melhor razão valor/altura dentre as que cabem na pilha (comparação sem divisões).
+    for(i = 0; i < p->n; i++)
+        if (p->caixas[i].a <= p->h && p->v[i] > 0 && p->caixas[i].a > 0 &&
+                (b == -1 || (long long) p->v[i] * p->caixas[b].a > (long long) p->v[b] * p->caixas[i].a))
+            b = i;
+
+    if (b == -1) // Nenhuma caixa cabe na pilha.
+        return 0;
+
+    // Repete a caixa b enquanto couber.
+    while (restante >= p->caixas[b].a && valor <= INT_MAX - p->v[b]) {
+        pilha[(*tam)++] = b;
+        restante -= p->caixas[b].a;
+        valor += p->v[b];
+    }
+
+    // Preenche o restante com a caixa de maior valor que cabe e é empilhável sobre o topo.
+    for(topo = b; ; topo = escolhida) {
+        escolhida = -1;
+        for(i = 0; i < p->n; i++)
+            if (p->caixas[i].a <= restante && p->caixas[i].a > 0 && p->v[i] > 0 &&
+                    p->caixas[i].l <= p->caixas[topo].l && p->caixas[i].p <= p->caixas[topo].p &&
+                    (escolhida == -1 || p->v[i] > p->v[escolhida]) && valor <= INT_MAX - p->v[i])
+                escolhida = i;
+
+        if (escolhida == -1)
+            break;
+
+        pilha[(*tam)++] = escolhida;
+        restante -= p->caixas[escolhida].a;
+        valor += p->v[escolhida];
+    }
+
+    return valor;
+} // fim da função torre_gulosa
+
+
+/* Encontra uma solução para o problema de empilhamento de caixas com a estratégia anytime
+ * descrita no início do arquivo. O parâmetro prazo é o tempo disponível, em segundos, contado a
+ * partir da chamada (se for menor ou igual a zero, não há prazo e a solução é ótima). O parâmetro
+ * limitante, passado por referência, receberá o limitante superior para o valor ótimo (igual ao
+ * valor retornado quando a solução é comprovadamente ótima).
+ *
+ * Os demais parâmetros e os valores de retorno são os mesmos da função empilhamento_bottom_up.
+ * Se não houver memória para a programação dinâmica, retorna-se a torre gulosa. Um pedido de
+ * cancelamento (ver acompanha_resolucao) tem o mesmo efeito do fim do prazo: retorna-se a melhor
+ * pilha encontrada até então, com o seu limitante.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n²h) até o prazo.
+ */
+int empilhamento_anytime(problema p, double prazo, int** vetor_de_caixas_empilhadas, int* tam, int* limitante)
+{
+    int **matriz_emp = NULL, **matriz_indices = NULL; // Matrizes da programação dinâmica.
+    lista *vetor_lista_de_caixas_empilhaveis = NULL; // Listas de caixas empilháveis.
+    tipo_nodo *no; // Variável auxiliar utilizada para percorrer a lista de caixas empilháveis.
+    int *pilha, *topo = NULL, tam_topo = 0; // Pilha em construção e pilha do trecho superior.
+    int i, j, k = 0, b, h_aux, linha, melhor_valor, melhor_b = -1, melhor_i = -1, melhor_c = 0; // Variáveis auxiliares.
+    int menor_altura = 0, maior_altura = 0, capacidade, valor, g, interrompida = 0; // Variáveis auxiliares.
+    long long c, candidato, limite, v_razao = 0, a_razao = 1; // Variáveis auxiliares.
+    double limite_tempo = instante_atual() + prazo; // Instante do prazo.
+
+    // Verifica se a variável passada como parâmetro representa memória alocada.
+    if (*vetor_de_caixas_empilhadas)
+        free(*vetor_de_caixas_empilhadas); // Libera a memória alocada.
+
+    *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
+    *tam = 0;                           // referência e que retornarão valores também.
+    *limitante = 0;
+
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
+    // Alturas mínima e máxima e melhor razão valor/altura, dentre as caixas que cabem na pilha.
+    for(i = 0; i < p->n; i++)
+        if (p->caixas[i].a <= p->h && p->caixas[i].a > 0) {
+            if (menor_altura == 0 || p->caixas[i].a < menor_altura)
+                menor_altura = p->caixas[i].a;
+            if (p->caixas[i].a > maior_altura)
+                maior_altura = p->caixas[i].a;
+            if (p->v[i] > 0 && (long long) p->v[i] * a_razao > v_razao * p->caixas[i].a) {
+                v_razao = p->v[i];
+                a_razao = p->caixas[i].a;
+            }
+        }
+
+    capacidade = (menor_altura > 0) ? (p->h / menor_altura + 1) : 1;
+    pilha = (int*) malloc(sizeof(int) * capacidade);
+    if (!pilha)
+        return -1; // Falha, devido à ausência de recursos computacionais.
+
+    // Solução inicial: torre gulosa. Limitante inicial: r*·h.
+    melhor_valor = torre_gulosa(p, pilha, tam);
+    limite = v_razao * p->h / a_razao;
+    *limitante = (limite < INT_MAX) ? (int) limite : INT_MAX;
+
+    // Se a torre gulosa não alcança o limitante, aloca as matrizes (sem fragmentação) e as listas
+    // de caixas empilháveis da programação dinâmica.
+    if (melhor_valor < *limitante) {
+        matriz_emp = (int**) malloc(sizeof(int*) * (p->h + 1));
+        matriz_indices = (int**) malloc(sizeof(int*) * (p->h + 1));
+        if (matriz_emp)
+            matriz_emp[0] = (int*) aloca_tabela(sizeof(int) * (p->h + 1) * p->n, &p->est.tipo_paginas);
+        if (matriz_indices)
+            matriz_indices[0] = (int*) aloca_tabela(sizeof(int) * (p->h + 1) * p->n, &p->est.tipo_paginas);
+        if (matriz_emp && matriz_emp[0] && matriz_indices && matriz_indices[0])
+            vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p);
+    }
+
+    if (vetor_lista_de_caixas_empilhaveis) {
+
+        for(i = 0; i < p->n; i++) { // A linha 0 (zero) tem solução conhecida.
+            matriz_emp[0][i] = 0;
+            matriz_indices[0][i] = -1;
+        }
+
+        // Calcula as linhas da matriz até o prazo, como na estratégia iterativa.
+        for(k = 1; k <= p->h && !interrompida && (prazo <= 0 || instante_atual() < limite_tempo); k++) {
+
+            matriz_emp[k] = matriz_emp[k - 1] + p->n;         // Corrige a referência de ponteiros da alocação
+            matriz_indices[k] = matriz_indices[k - 1] + p->n; // dinâmica de matriz sem fragmentação.
+
+            for(i = 0, g = 0; i < p->n; i++) {
+                matriz_emp[k][i] = 0;
+                matriz_indices[k][i] = -1;
+
+                h_aux = k - p->caixas[i].a;
+
+                if (h_aux >= 0) {
+                    p->est.subproblemas++;
+                    p->est.transicoes += vetor_lista_de_caixas_empilhaveis[i]->tamanho;
+
+                    for(no = vetor_lista_de_caixas_empilhaveis[i]->first; no; no = no->next) {
+                        j = no->item.chave;
+                        if (p->v[i] + matriz_emp[h_aux][j] > matriz_emp[k][i]) {
+                            matriz_emp[k][i] = p->v[i] + matriz_emp[h_aux][j];
+                            if (matriz_emp[h_aux][j] != 0)
+                                matriz_indices[k][i] = j;
+                        }
+                    }
+                }
+
+                if (matriz_emp[k][i] > g)
+                    g = matriz_emp[k][i];
+            }
+
+            // Atualiza o limitante com a linha k: g(k) + r*·(h - k + A - 1), ou g(h) na última linha.
+            limite = (k == p->h) ? g : g + v_razao * (p->h - k + maior_altura - 1) / a_razao;
+            if (limite < *limitante)
+                *limitante = (int) limite;
+
+            if (melhor_valor >= *limitante) // A torre gulosa já é ótima.
+                break;
+
+            // Informa o progresso e verifica se houve pedido de cancelamento (equivalente ao fim do prazo).
+            if (k % INTERVALO_CONTROLE == 0 || k == p->h)
+                interrompida = acompanha_resolucao(p, k, p->h);
+        }
+        k = (k > p->h) ? p->h : k - 1; // Última linha calculada.
+        if (melhor_valor >= *limitante)
+            k = 0; // Nenhuma pilha da matriz supera a torre gulosa.
+
+        // Para cada caixa b, c cópias de b sob a melhor pilha da linha h - c·a(b) apoiada sobre b.
+        for(b = 0; b < p->n && k > 0; b++) {
+            if (p->caixas[b].a > p->h || p->caixas[b].a <= 0)
+                continue;
+
+            c = (p->h - k + p->caixas[b].a - 1) / p->caixas[b].a; // Menor c com h - c·a(b) <= k.
+            if (c > p->h / p->caixas[b].a)
+                c = p->h / p->caixas[b].a;
+            linha = p->h - (int) (c * p->caixas[b].a);
+            if (linha > k)
+                linha = k;
+
+            for(no = vetor_lista_de_caixas_empilhaveis[b]->first; no; no = no->next) {
+                candidato = c * p->v[b] + matriz_emp[linha][no->item.chave];
+                if (candidato > melhor_valor && candidato <= INT_MAX) {
+                    melhor_valor = (int) candidato;
+                    melhor_b = b;
+                    melhor_i = no->item.chave;
+                    melhor_c = (int) c;
+                }
+            }
+        }
+
+        if (melhor_b != -1) { // A pilha composta supera a torre gulosa.
+            c = melhor_c;
+            linha = p->h - (int) (c * p->caixas[melhor_b].a);
+            if (linha > k)
+                linha = k;
+
+            if (matriz_emp[linha][melhor_i] > 0) {
+                topo = reconstroi_pilha(matriz_indices, p->caixas, p->n, linha, melhor_i, &tam_topo);
+                if (!topo)
+                    melhor_valor = -1; // Falha, devido à ausência de recursos computacionais.
+            }
+
+            if (melhor_valor != -1) {
+                for(*tam = 0; *tam < melhor_c; (*tam)++)
+                    pilha[*tam] = melhor_b;
+                for(i = 0; i < tam_topo && *tam < capacidade; i++)
+                    pilha[(*tam)++] = topo[i];
+            }
+            free(topo);
+        }
+    }
+
+    if (matriz_emp)
+        libera_tabela(matriz_emp[0]);
+    if (matriz_indices)
+        libera_tabela(matriz_indices[0]);
+    free(matriz_emp);
+    free(matriz_indices);
+    if (vetor_lista_de_caixas_empilhaveis)
+        termina_vetor_lista_de_caixas_empilhaveis(vetor_lista_de_caixas_empilhaveis, p->n);
+
+    valor = melhor_valor;
+    if (valor > 0)
+        *vetor_de_caixas_empilhadas = pilha;
+    else {
+        free(pilha);
+        *tam = 0;
+    }
+
+    if (*limitante < valor) // A torre gulosa pode alcançar o limitante inicial.
+        *limitante = valor;
+
+    return valor; // Retorna o valor da solução ou -1, em caso de falha na alocação de memória.
+} // fim da função empilhamento_anytime
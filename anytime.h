@@ -0,0 +1,10 @@
+#ifndef ANYTIME_H_INCLUDED
+#define ANYTIME_H_INCLUDED
+
+#include "estruturas.h"
+
+int torre_gulosa(problema, int*, int*);
+
+int empilhamento_anytime(problema, double, int**, int*, int*);
+
+#endif // ANYTIME_H_INCLUDED
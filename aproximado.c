@@ -0,0 +1,183 @@
+#include <stdlib.h>
+#include "aproximado.h"
+
+/* Estratégia aproximada por escala de alturas, para instâncias em que h é muito grande (por
+ * exemplo, alturas medidas em milímetros). O custo da programação dinâmica é linear em h; com as
+ * alturas medidas em unidades de s, ele é dividido por s.
+ *
+ * A escala é s = piso(ε·a_min), em que a_min é a menor altura de caixa (e s é no mínimo 1). Cada
+ * altura arredondada para cima, teto(a / s)·s, excede a altura real em menos de s <= ε·a, isto é,
+ * em no máximo uma fração ε.
+ *
+ *      - Problema pessimista: alturas teto(a / s) e altura máxima piso(h / s). Toda pilha viável
+ *        nele é viável no problema real, pois a sua altura real não excede s·piso(h / s) <= h. A
+ *        pilha obtida é conferida com as alturas reais e completada, no topo, com as caixas de
+ *        maior valor que ainda couberem na folga deixada pelos arredondamentos.
+ *      - Problema otimista: alturas piso(a / s) e altura máxima piso(h / s). Toda pilha viável no
+ *        problema real é viável nele, pois a soma dos pisos não excede o piso da soma. O seu valor
+ *        ótimo é, portanto, um limitante superior para o ótimo real.
+ *
+ * A razão entre o valor obtido e o limitante é a garantia (a posteriori) da solução: o valor
+ * obtido é de no mínimo essa fração do ótimo.
+ */
+
+
+/* Cria uma cópia do problema p com as alturas medidas em unidades de s, arredondadas para cima
+ * (se para_cima é diferente de zero) ou para baixo, e altura máxima piso(h / s). A cópia
+ * compartilha o controle da resolução de p.
+ *
+ * Retorna a cópia ou NULL, em caso de falha na alocação de memória.
+ *
+ * Complexidade: O(n)
+ */
+problema cria_problema_escalado(problema p, int s, int para_cima)
+{
+    problema q = cria_problema(p->n, p->h / s); // Problema escalado.
+    caixa c; // Variável auxiliar.
+    int i; // Variável auxiliar.
+
+    if (q) {
+        q->controle = p->controle;
+        q->perfil = p->perfil;
+        for(i = 0; i < p->n; i++) {
+            c = p->caixas[i];
+            c.a = para_cima ? (c.a + s - 1) / s : c.a / s;
+            add_caixa(q, c);
+            add_valor(q, p->v[i]);
+        }
+    }
+
+    return q;
+} // fim da função cria_problema_escalado
+
+
+/* Encontra uma solução aproximada para o problema de empilhamento de caixas, com a estratégia
+ * descrita no início do arquivo. O parâmetro epsilon é o erro relativo admitido nas alturas (se
+ * for menor ou igual a zero, usa-se EPSILON_PADRAO). O parâmetro limitante, passado por
+ * referência, receberá o limitante superior para o valor ótimo.
+ *
+ * Os demais parâmetros e os valores de retorno são os mesmos da função empilhamento_bottom_up
+ * (inclusive RESOLUCAO_CANCELADA, se o cancelamento for pedido durante uma das resoluções).
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n²h / s)
+ */
+int empilhamento_aproximado(problema p, double epsilon, int** vetor_de_caixas_empilhadas, int* tam, int* limitante)
+{
+    problema q; // Problema escalado.
+    estatisticas_empilhamento est = {0}; // Contadores acumulados das duas resoluções.
+    int *pilha = NULL, *relaxada = NULL, tam_relaxada = 0, capacidade; // Pilhas e capacidade do vetor.
+    int i, s, a_min = 0, altura = 0, valor, topo, escolhida; // Variáveis auxiliares.
+
+    // Verifica se a variável passada como parâmetro representa memória alocada.
+    if (*vetor_de_caixas_empilhadas)
+        free(*vetor_de_caixas_empilhadas); // Libera a memória alocada.
+
+    *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
+    *tam = 0;                           // referência e que retornarão valores também.
+    *limitante = 0;
+
+    if (epsilon <= 0)
+        epsilon = EPSILON_PADRAO;
+
+    for(i = 0; i < p->n; i++)
+        if (p->caixas[i].a > 0 && (a_min == 0 || p->caixas[i].a < a_min))
+            a_min = p->caixas[i].a;
+
+    // A escala não excede a menor altura, para que nenhuma altura arredondada para baixo se anule.
+    s = (int) (epsilon * a_min);
+    if (s > a_min)
+        s = a_min;
+    if (s < 1)
+        s = 1;
+
+    // Problema pessimista: a sua solução é viável no problema real.
+    q = cria_problema_escalado(p, s, 1);
+    if (!q)
+        return -1; // Falha, devido à ausência de recursos computacionais.
+    valor = empilhamento_bottom_up(q, &pilha, tam);
+    est.subproblemas += q->est.subproblemas;
+    est.transicoes += q->est.transicoes;
+    est.segundos_grafo += q->est.segundos_grafo;
+    est.tipo_paginas = q->est.tipo_paginas;
+    termina_problema(q);
+
+    if (valor < 0)
+        return valor; // Falha, devido à ausência de recursos computacionais, ou cancelamento.
+
+    // Confere a pilha com as alturas reais; por construção, ela cabe na altura h.
+    for(i = 0; i < *tam; i++)
+        altura += p->caixas[pilha[i]].a;
+    while (*tam > 0 && altura > p->h) { // Salvaguarda: retira caixas do topo até caber.
+        altura -= p->caixas[pilha[--(*tam)]].a;
+        valor -= p->v[pilha[*tam]];
+    }
+
+    // Completa o topo com as caixas de maior valor que cabem na folga e são empilháveis.
+    capacidade = (a_min > 0) ? (p->h / a_min + 1) : (p->h + 1);
+    if (*tam < capacidade) {
+        relaxada = (int*) realloc(pilha, sizeof(int) * capacidade);
+        if (!relaxada) {
+            free(pilha);
+            return -1; // Falha, devido à ausência de recursos computacionais.
+        }
+        pilha = relaxada;
+        relaxada = NULL;
+    }
+
+    for(topo = (*tam > 0) ? pilha[*tam - 1] : -1; *tam < capacidade; topo = escolhida) {
+        escolhida = -1;
+        for(i = 0; i < p->n; i++)
+            if (p->caixas[i].a > 0 && altura + p->caixas[i].a <= p->h && p->v[i] > 0 &&
+                    (topo == -1 || (p->caixas[i].l <= p->caixas[topo].l && p->caixas[i].p <= p->caixas[topo].p)) &&
+                    (escolhida == -1 || p->v[i] > p->v[escolhida]))
+                escolhida = i;
+
+        if (escolhida == -1)
+            break;
+
+        pilha[(*tam)++] = escolhida;
+        altura += p->caixas[escolhida].a;
+        valor += p->v[escolhida];
+    }
+
+    // Problema otimista: o seu valor ótimo é o limitante superior. Com s = 1, a solução é exata.
+    if (s == 1)
+        *limitante = valor;
+    else {
+        q = cria_problema_escalado(p, s, 0);
+        *limitante = q ? empilhamento_bottom_up(q, &relaxada, &tam_relaxada) : -1;
+        if (q) {
+            est.subproblemas += q->est.subproblemas;
+            est.transicoes += q->est.transicoes;
+            est.segundos_grafo += q->est.segundos_grafo;
+        }
+        termina_problema(q);
+        free(relaxada);
+
+        if (*limitante < 0) {
+            valor = *limitante;
+            free(pilha);
+            *tam = 0;
+            return valor; // Falha, devido à ausência de recursos computacionais, ou cancelamento.
+        }
+        if (*limitante < valor) // Não ocorre: o ótimo otimista não é menor do que qualquer pilha viável.
+            *limitante = valor;
+    }
+
+    p->est.subproblemas = est.subproblemas;
+    p->est.transicoes = est.transicoes;
+    p->est.segundos_grafo = est.segundos_grafo;
+    p->est.tipo_paginas = est.tipo_paginas;
+
+    if (valor > 0)
+        *vetor_de_caixas_empilhadas = pilha;
+    else {
+        free(pilha);
+        *tam = 0;
+    }
+
+    return valor; // Retorna o valor da solução ou -1, em caso de falha na alocação de memória.
+} // fim da função empilhamento_aproximado
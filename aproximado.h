@@ -0,0 +1,11 @@
+#ifndef APROXIMADO_H_INCLUDED
+#define APROXIMADO_H_INCLUDED
+
+#include "estruturas.h"
+
+/* Erro relativo padrão da estratégia aproximada. */
+#define EPSILON_PADRAO 0.05
+
+int empilhamento_aproximado(problema, double, int**, int*, int*);
+
+#endif // APROXIMADO_H_INCLUDED
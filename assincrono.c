@@ -0,0 +1,379 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "assincrono.h"
+
+/* Resolução assíncrona, para o uso do solucionador embutido em outro processo. Um executor mantém
+ * um número fixo de threads e uma fila limitada de tarefas: a submissão de um problema retorna
+ * imediatamente uma tarefa (um "futuro"), que pode ser consultada sem bloqueio, aguardada ou
+ * cancelada. Muitas resoluções simultâneas compartilham, assim, as mesmas threads.
+ *
+ * Cada tarefa tem o seu controle de resolução (ver estruturas.h), ligado ao problema enquanto ele
+ * é resolvido. As estratégias consultam o controle a cada INTERVALO_CONTROLE linhas da matriz (ou a
+ * cada caixa da base, nas recursivas): informam o progresso e, se o cancelamento foi pedido,
+ * interrompem a resolução, que retorna RESOLUCAO_CANCELADA. Uma tarefa cancelada antes de sair da
+ * fila não chega a ser executada.
+ *
+ * A conclusão também pode ser notificada por uma função, chamada na thread que concluiu a tarefa,
+ * o que permite retomar uma corrotina ou um laço de eventos sem bloquear nenhuma thread.
+ *
+ * Todo o estado é protegido por uma única trava do executor; as tarefas devem, portanto, ser
+ * liberadas (termina_tarefa) antes do executor que as criou.
+ */
+
+#define TAMANHO_PILHA_EXECUTOR (64 * 1024 * 1024) // Tamanho da pilha de execução de cada thread.
+
+struct tarefa_empilhamento {
+    executor ex; // Executor ao qual a tarefa foi submetida.
+    problema p; // Problema a ser resolvido.
+    opcoes_empilhamento opcoes; // Cópia das opções de resolução.
+    acompanhamento_empilhamento acompanhamento; // Funções de progresso e de conclusão.
+    controle_resolucao controle; // Controle de cancelamento e progresso da resolução.
+    solucao_empilhamento s; // Solução, válida após a conclusão.
+    int estado; // Um dos estados TAREFA_*.
+    struct tarefa_empilhamento* proxima; // Próxima tarefa da fila do executor.
+};
+
+typedef struct {
+    executor ex; // Executor ao qual a thread pertence.
+    pthread_t id; // Identificador da thread.
+    tarefa atual; // Tarefa em execução pela thread (NULL se nenhuma).
+} trabalhador;
+
+struct executor_empilhamento {
+    pthread_mutex_t trava; // Protege a fila, os estados das tarefas e as tarefas em execução.
+    pthread_cond_t nova_tarefa; // Sinaliza a inserção de uma tarefa na fila (ou o encerramento).
+    pthread_cond_t tarefa_concluida; // Sinaliza a conclusão de alguma tarefa.
+    tarefa primeira, ultima; // Extremidades da fila de tarefas pendentes.
+    int pendentes, capacidade; // Número de tarefas na fila e número máximo.
+    int encerrar; // Se diferente de zero, as threads devem terminar.
+    int num_threads; // Número de threads criadas.
+    trabalhador* trabalhadores; // Dados de cada thread.
+};
+
+
+/* Conclui uma tarefa já retirada da fila: chama a função de conclusão, fora da trava, e só então
+ * marca a tarefa como concluída, acordando quem a aguarda.
+ *
+ * Complexidade: O(1), além da função de conclusão.
+ */
+void conclui_tarefa(tarefa t)
+{
+    if (t->acompanhamento.conclusao)
+        t->acompanhamento.conclusao(&t->s, t->acompanhamento.dados);
+
+    pthread_mutex_lock(&t->ex->trava);
+    t->estado = TAREFA_CONCLUIDA;
+    pthread_cond_broadcast(&t->ex->tarefa_concluida);
+    pthread_mutex_unlock(&t->ex->trava);
+} // fim da função conclui_tarefa
+
+
+/* Laço de cada thread do executor: retira a primeira tarefa da fila, resolve o problema sob o
+ * controle da tarefa e a conclui, até o encerramento do executor.
+ */
+void* executa_trabalhador(void* arg)
+{
+    trabalhador* w = (trabalhador*) arg; // Dados da thread.
+    executor ex = w->ex; // Executor ao qual a thread pertence.
+    tarefa t; // Tarefa em execução.
+
+    pthread_mutex_lock(&ex->trava);
+    while (1) {
+        while (!ex->primeira && !ex->encerrar)
+            pthread_cond_wait(&ex->nova_tarefa, &ex->trava);
+        if (!ex->primeira)
+            break; // Encerramento, com a fila vazia.
+
+        t = ex->primeira;
+        ex->primeira = t->proxima;
+        if (!ex->primeira)
+            ex->ultima = NULL;
+        ex->pendentes--;
+        t->estado = TAREFA_EXECUTANDO;
+        w->atual = t;
+        pthread_mutex_unlock(&ex->trava);
+
+        t->p->controle = &t->controle;
+        resolve_empilhamento(t->p, &t->opcoes, &t->s);
+        t->p->controle = NULL;
+
+        pthread_mutex_lock(&ex->trava);
+        w->atual = NULL;
+        pthread_mutex_unlock(&ex->trava);
+
+        conclui_tarefa(t);
+
+        pthread_mutex_lock(&ex->trava);
+    }
+    pthread_mutex_unlock(&ex->trava);
+
+    return NULL;
+} // fim da função executa_trabalhador
+
+
+/* Cria um executor com num_threads threads (se for menor ou igual a zero, usa-se uma por
+ * processador) e uma fila de, no máximo, capacidade tarefas pendentes (sem limite, se for menor
+ * ou igual a zero).
+ *
+ * Retorna o executor ou NULL, em caso de falha na alocação de recursos computacionais.
+ *
+ * Complexidade: O(num_threads)
+ */
+executor cria_executor(int num_threads, int capacidade)
+{
+    executor ex; // Executor que será retornado pela função.
+    pthread_attr_t atributos; // Atributos das threads (tamanho da pilha de execução).
+    int i; // Variável auxiliar.
+
+    if (num_threads <= 0)
+        num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_threads <= 0)
+        num_threads = 1;
+
+    ex = (executor) malloc(sizeof(struct executor_empilhamento));
+    if (!ex)
+        return NULL; // Falha, devido à ausência de recursos computacionais.
+
+    ex->trabalhadores = (trabalhador*) malloc(sizeof(trabalhador) * num_threads);
+    if (!ex->trabalhadores) {
+        free(ex);
+        return NULL; // Falha, devido à ausência de recursos computacionais.
+    }
+
+    pthread_mutex_init(&ex->trava, NULL);
+    pthread_cond_init(&ex->nova_tarefa, NULL);
+    pthread_cond_init(&ex->tarefa_concluida, NULL);
+    ex->primeira = ex->ultima = NULL;
+    ex->pendentes = 0;
+    ex->capacidade = capacidade;
+    ex->encerrar = 0;
+
+    // As estratégias recursivas precisam de uma pilha de execução maior do que a padrão.
+    pthread_attr_init(&atributos);
+    pthread_attr_setstacksize(&atributos, TAMANHO_PILHA_EXECUTOR);
+
+    for(ex->num_threads = 0; ex->num_threads < num_threads; ex->num_threads++) {
+        i = ex->num_threads;
+        ex->trabalhadores[i].ex = ex;
+        ex->trabalhadores[i].atual = NULL;
+        if (pthread_create(&ex->trabalhadores[i].id, &atributos, executa_trabalhador, &ex->trabalhadores[i]) != 0)
+            break;
+    }
+
+    pthread_attr_destroy(&atributos);
+
+    if (ex->num_threads == 0) { // Nenhuma thread pôde ser criada.
+        termina_executor(ex);
+        return NULL;
+    }
+
+    return ex; // Retorna o executor criado.
+} // fim da função cria_executor
+
+
+/* Encerra o executor: as tarefas pendentes são concluídas como canceladas, o cancelamento das
+ * tarefas em execução é pedido e, após o término das threads, a memória do executor é liberada.
+ * As tarefas ainda não liberadas continuam válidas apenas para termina_tarefa, que deve ser
+ * chamada antes desta função.
+ *
+ * Complexidade: O(número de tarefas pendentes + num_threads), além da espera pelas threads.
+ */
+void termina_executor(executor ex)
+{
+    tarefa t, pendentes; // Tarefas retiradas da fila.
+    int i; // Variável auxiliar.
+
+    if (!ex)
+        return;
+
+    pthread_mutex_lock(&ex->trava);
+    ex->encerrar = 1;
+    pendentes = ex->primeira;
+    ex->primeira = ex->ultima = NULL;
+    ex->pendentes = 0;
+    for(t = pendentes; t; t = t->proxima)
+        t->estado = TAREFA_EXECUTANDO; // Retiradas da fila, serão concluídas abaixo.
+    for(i = 0; i < ex->num_threads; i++)
+        if (ex->trabalhadores[i].atual)
+            atomic_store(&ex->trabalhadores[i].atual->controle.cancelar, 1);
+    pthread_cond_broadcast(&ex->nova_tarefa);
+    pthread_mutex_unlock(&ex->trava);
+
+    while (pendentes) {
+        t = pendentes;
+        pendentes = t->proxima;
+        conclui_tarefa(t);
+    }
+
+    for(i = 0; i < ex->num_threads; i++)
+        pthread_join(ex->trabalhadores[i].id, NULL);
+
+    pthread_cond_destroy(&ex->nova_tarefa);
+    pthread_cond_destroy(&ex->tarefa_concluida);
+    pthread_mutex_destroy(&ex->trava);
+    free(ex->trabalhadores);
+    free(ex);
+} // fim da função termina_executor
+
+
+/* Submete o problema p à resolução assíncrona pelo executor, com as opções informadas (NULL usa
+ * as opções padrão; os nomes de arquivos da estratégia em memória externa devem permanecer
+ * válidos até a conclusão) e as funções de acompanhamento (NULL se não houver). Até a conclusão
+ * da tarefa, o problema não deve ser alterado, resolvido ou submetido novamente.
+ *
+ * Retorna a tarefa, que deve ser liberada posteriormente com a função termina_tarefa, ou NULL se
+ * a fila do executor estiver cheia, se o executor estiver sendo encerrado ou em caso de falha na
+ * alocação de memória.
+ *
+ * Complexidade: O(1)
+ */
+tarefa submete_empilhamento(executor ex, problema p, const opcoes_empilhamento* opcoes,
+                            const acompanhamento_empilhamento* acompanhamento)
+{
+    tarefa t; // Tarefa que será retornada pela função.
+
+    if (!ex || !p)
+        return NULL;
+
+    t = (tarefa) malloc(sizeof(struct tarefa_empilhamento));
+    if (!t)
+        return NULL; // Falha, devido à ausência de recursos computacionais.
+
+    t->ex = ex;
+    t->p = p;
+    if (opcoes)
+        t->opcoes = *opcoes;
+    else
+        inicializa_opcoes(&t->opcoes);
+    t->acompanhamento.progresso = acompanhamento ? acompanhamento->progresso : NULL;
+    t->acompanhamento.conclusao = acompanhamento ? acompanhamento->conclusao : NULL;
+    t->acompanhamento.dados = acompanhamento ? acompanhamento->dados : NULL;
+    atomic_init(&t->controle.cancelar, 0);
+    t->controle.progresso = t->acompanhamento.progresso;
+    t->controle.dados = t->acompanhamento.dados;
+    t->s.valor = t->s.limitante = RESOLUCAO_CANCELADA; // Valor de uma tarefa que não chega a executar.
+    t->s.caixas = NULL;
+    t->s.tam = 0;
+    t->s.est = p->est;
+    t->estado = TAREFA_PENDENTE;
+    t->proxima = NULL;
+
+    pthread_mutex_lock(&ex->trava);
+    if (ex->encerrar || (ex->capacidade > 0 && ex->pendentes >= ex->capacidade)) {
+        pthread_mutex_unlock(&ex->trava);
+        free(t);
+        return NULL; // Fila cheia ou executor em encerramento.
+    }
+
+    if (ex->ultima)
+        ex->ultima->proxima = t;
+    else
+        ex->primeira = t;
+    ex->ultima = t;
+    ex->pendentes++;
+    pthread_cond_signal(&ex->nova_tarefa);
+    pthread_mutex_unlock(&ex->trava);
+
+    return t; // Retorna a tarefa criada.
+} // fim da função submete_empilhamento
+
+
+/* Pede o cancelamento da tarefa. Uma tarefa pendente é retirada da fila e concluída imediatamente,
+ * na thread que pediu o cancelamento; uma tarefa em execução é interrompida pela estratégia na
+ * próxima consulta ao controle. Não tem efeito sobre tarefas concluídas. Nos dois primeiros casos,
+ * o valor da solução será RESOLUCAO_CANCELADA (exceto na estratégia anytime, que retorna a melhor
+ * pilha encontrada até o cancelamento).
+ *
+ * Complexidade: O(número de tarefas pendentes)
+ */
+void cancela_empilhamento(tarefa t)
+{
+    executor ex; // Executor da tarefa.
+    tarefa *anterior, aux; // Variáveis auxiliares para a remoção da fila.
+
+    if (!t)
+        return;
+
+    ex = t->ex;
+    atomic_store(&t->controle.cancelar, 1);
+
+    pthread_mutex_lock(&ex->trava);
+    if (t->estado != TAREFA_PENDENTE) {
+        pthread_mutex_unlock(&ex->trava);
+        return; // A tarefa em execução atende ao pedido pelo seu controle.
+    }
+
+    for(anterior = &ex->primeira, aux = NULL; *anterior != t; anterior = &(*anterior)->proxima)
+        aux = *anterior;
+    *anterior = t->proxima;
+    if (ex->ultima == t)
+        ex->ultima = aux;
+    ex->pendentes--;
+    t->estado = TAREFA_EXECUTANDO; // Retirada da fila, é concluída abaixo.
+    pthread_mutex_unlock(&ex->trava);
+
+    conclui_tarefa(t);
+} // fim da função cancela_empilhamento
+
+
+/* Consulta, sem bloqueio, se a tarefa foi concluída.
+ *
+ * Retorna 1 (um) se a tarefa foi concluída ou 0 (zero), caso contrário.
+ *
+ * Complexidade: O(1)
+ */
+int concluida_empilhamento(tarefa t)
+{
+    int concluida; // Variável auxiliar.
+
+    pthread_mutex_lock(&t->ex->trava);
+    concluida = (t->estado == TAREFA_CONCLUIDA);
+    pthread_mutex_unlock(&t->ex->trava);
+
+    return concluida;
+} // fim da função concluida_empilhamento
+
+
+/* Aguarda a conclusão da tarefa e, se s não for NULL, transfere a solução para s, que deve ser
+ * liberada posteriormente com a função termina_solucao (a tarefa fica com o valor, mas sem a
+ * pilha). Não deve ser chamada pela função de conclusão da própria tarefa.
+ *
+ * Retorna o valor da solução, -1 em caso de falha ou RESOLUCAO_CANCELADA, se a tarefa foi
+ * cancelada.
+ *
+ * Complexidade: O(1), além da espera.
+ */
+int aguarda_empilhamento(tarefa t, solucao_empilhamento* s)
+{
+    pthread_mutex_lock(&t->ex->trava);
+    while (t->estado != TAREFA_CONCLUIDA)
+        pthread_cond_wait(&t->ex->tarefa_concluida, &t->ex->trava);
+    pthread_mutex_unlock(&t->ex->trava);
+
+    if (s) {
+        *s = t->s;
+        t->s.caixas = NULL; // A pilha passa a pertencer a s.
+        t->s.tam = 0;
+    }
+
+    return t->s.valor;
+} // fim da função aguarda_empilhamento
+
+
+/* Libera a tarefa: pede o seu cancelamento, caso ainda não tenha sido concluída, aguarda a
+ * conclusão e desaloca a memória da tarefa e da solução que ainda estiver nela.
+ *
+ * Complexidade: O(número de tarefas pendentes), além da espera.
+ */
+void termina_tarefa(tarefa t)
+{
+    if (!t)
+        return;
+
+    cancela_empilhamento(t);
+    aguarda_empilhamento(t, NULL);
+    termina_solucao(&t->s);
+    free(t);
+} // fim da função termina_tarefa
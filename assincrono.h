@@ -0,0 +1,43 @@
+#ifndef ASSINCRONO_H_INCLUDED
+#define ASSINCRONO_H_INCLUDED
+
+#include "empilhamento.h"
+
+/* Estados de uma tarefa de resolução: */
+#define TAREFA_PENDENTE 0 // Na fila do executor, aguardando uma thread.
+#define TAREFA_EXECUTANDO 1 // Em resolução (ou sendo concluída).
+#define TAREFA_CONCLUIDA 2 // Concluída, com a solução disponível.
+
+/* Função chamada ao final de uma tarefa (resolvida, cancelada ou com falha), na thread que a
+ * concluiu: recebe a solução, que pertence à tarefa e não deve ser liberada, e os dados
+ * informados na submissão. */
+typedef void (*funcao_conclusao)(const solucao_empilhamento*, void*);
+
+typedef struct {
+    /* Acompanhamento do progresso (linhas concluídas de h, ou caixas da base, ver estruturas.h): */
+    funcao_progresso progresso;
+    /* Notificação da conclusão da tarefa: */
+    funcao_conclusao conclusao;
+    /* Dados repassados às duas funções: */
+    void* dados;
+} acompanhamento_empilhamento;
+
+typedef struct executor_empilhamento* executor;
+
+typedef struct tarefa_empilhamento* tarefa;
+
+executor cria_executor(int, int);
+
+void termina_executor(executor);
+
+tarefa submete_empilhamento(executor, problema, const opcoes_empilhamento*, const acompanhamento_empilhamento*);
+
+void cancela_empilhamento(tarefa);
+
+int concluida_empilhamento(tarefa);
+
+int aguarda_empilhamento(tarefa, solucao_empilhamento*);
+
+void termina_tarefa(tarefa);
+
+#endif // ASSINCRONO_H_INCLUDED
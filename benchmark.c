@@ -0,0 +1,636 @@
+/*
+* Programa auxiliar para medição de desempenho das estratégias de resolução do problema de
+* empilhamento de caixas. Cada instância é lida uma única vez e resolvida repetidas vezes por
+* cada estratégia selecionada, registrando-se o menor tempo e a mediana das execuções.
+*
+* O programa também serve para conferir as estratégias: no modo de verificação, cada pilha
+* obtida é validada e o seu valor é comparado com o das demais estratégias e com o arquivo
+* .sol da instância (quando existe); no modo diferencial, instâncias pequenas são geradas
+* aleatoriamente e resolvidas por todas as estratégias, que devem concordar entre si. Nesse modo,
+* podem ser conferidos também os modos de uso da biblioteca: as K melhores pilhas, a resolução
+* assíncrona, o cache de soluções, a retomada da estratégia em memória externa e o processamento
+* em lote por vários processos.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "funcoes.h"
+#include "empilhamento.h"
+#include "valores.h"
+#include "grafo.h"
+#include "assincrono.h"
+#include "cache.h"
+#include "lote.h"
+
+#define BOTTOM_UP_GERAL NUM_MOTORES // Posição da estratégia iterativa sem especialização na seleção.
+#define CAIXAS_ALEATORIAS_PADRAO 12 // Número máximo padrão de caixas das instâncias aleatórias.
+#define MAXIMO_CAIXAS_ALEATORIAS 128 // Limite do parâmetro -c (256 rotações, a maior linha de pequeno.c).
+#define MELHORES_PILHAS 3 // Número de pilhas pedidas na verificação das K melhores pilhas.
+#define PROCESSOS_LOTE 2 // Número de processos na verificação do processamento em lote.
+
+/* Dados de uma instância aleatória, mantidos para gerar cópias e arquivos de entrada. */
+typedef struct {
+    int n, h; // Número de caixas e altura máxima.
+    int l[MAXIMO_CAIXAS_ALEATORIAS], a[MAXIMO_CAIXAS_ALEATORIAS]; // Larguras e alturas.
+    int p[MAXIMO_CAIXAS_ALEATORIAS], v[MAXIMO_CAIXAS_ALEATORIAS]; // Profundidades e valores.
+} instancia_aleatoria;
+
+/* Compara dois tempos, para ordenação crescente com a função qsort. */
+int compara_tempo(const void* x, const void* y)
+{
+    double d = *(const double*) x - *(const double*) y;
+    return (d > 0) - (d < 0);
+} // fim da função compara_tempo
+
+
+/* Gerador de números pseudoaleatórios (xorshift64*), cujo estado é mantido pelo chamador. */
+unsigned int sorteia(unsigned long long* estado)
+{
+    *estado ^= *estado >> 12;
+    *estado ^= *estado << 25;
+    *estado ^= *estado >> 27;
+    return (unsigned int) ((*estado * 2685821657736338717ULL) >> 32);
+} // fim da função sorteia
+
+
+/* Gera uma instância aleatória pequena, com até max_caixas caixas (no máximo
+ * MAXIMO_CAIXAS_ALEATORIAS) de dimensões entre 1 e 8 e valores entre 1 e 20. A altura máxima fica
+ * entre 1 e 60 ou, em um quarto das instâncias, entre 1 e 3000, para que o regime periódico das
+ * soluções também seja exercitado. Os dados da instância são gravados em inst. Retorna NULL em
+ * caso de falha de alocação.
+ */
+problema gera_instancia_aleatoria(unsigned long long* estado, int max_caixas, instancia_aleatoria* inst)
+{
+    int i; // Variável auxiliar.
+
+    inst->n = 1 + sorteia(estado) % max_caixas;
+    inst->h = 1 + sorteia(estado) % ((sorteia(estado) % 4 == 0) ? 3000 : 60);
+
+    for(i = 0; i < inst->n; i++) {
+        inst->l[i] = 1 + sorteia(estado) % 8;
+        inst->a[i] = 1 + sorteia(estado) % 8;
+        inst->p[i] = 1 + sorteia(estado) % 8;
+        inst->v[i] = 1 + sorteia(estado) % 20;
+    }
+
+    return cria_problema_de_vetores(inst->n, inst->h, inst->l, inst->a, inst->p, inst->v);
+} // fim da função gera_instancia_aleatoria
+
+
+/* Gera uma cópia da instância com as caixas em outra ordem, sorteada. Retorna NULL em caso de
+ * falha de alocação.
+ */
+problema embaralha_instancia(const instancia_aleatoria* inst, unsigned long long* estado)
+{
+    instancia_aleatoria copia = *inst; // Dados da cópia.
+    int i, j, t; // Variáveis auxiliares.
+
+    for(i = copia.n - 1; i > 0; i--) { // Embaralhamento de Fisher-Yates.
+        j = sorteia(estado) % (i + 1);
+        t = copia.l[i]; copia.l[i] = copia.l[j]; copia.l[j] = t;
+        t = copia.a[i]; copia.a[i] = copia.a[j]; copia.a[j] = t;
+        t = copia.p[i]; copia.p[i] = copia.p[j]; copia.p[j] = t;
+        t = copia.v[i]; copia.v[i] = copia.v[j]; copia.v[j] = t;
+    }
+
+    return cria_problema_de_vetores(copia.n, copia.h, copia.l, copia.a, copia.p, copia.v);
+} // fim da função embaralha_instancia
+
+
+/* Grava a instância no arquivo de nome informado, no formato dos arquivos de entrada (número de
+ * caixas, altura máxima, valores e dimensões). Retorna 1 (um) em caso de sucesso ou 0 (zero),
+ * caso contrário.
+ */
+int grava_instancia(const char* nome, const instancia_aleatoria* inst)
+{
+    FILE* arq = fopen(nome, "w"); // Arquivo de entrada gerado.
+    int i, sucesso; // Variáveis auxiliares.
+
+    if (!arq)
+        return 0;
+
+    fprintf(arq, "%d\n%d\n", inst->n, inst->h);
+    for(i = 0; i < inst->n; i++)
+        fprintf(arq, "%d\n", inst->v[i]);
+    for(i = 0; i < inst->n; i++)
+        fprintf(arq, "%d %d %d\n", inst->l[i], inst->a[i], inst->p[i]);
+
+    sucesso = !ferror(arq);
+    return (fclose(arq) == 0) && sucesso;
+} // fim da função grava_instancia
+
+
+/* Função de acompanhamento que pede o cancelamento da resolução (cujo controle é passado em
+ * dados) a partir da metade das linhas.
+ */
+void interrompe_externo(long long feito, long long total, void* dados)
+{
+    if (2 * feito >= total)
+        ((controle_resolucao*) dados)->cancelar = 1;
+} // fim da função interrompe_externo
+
+
+/* Função de conclusão das tarefas assíncronas: conta as chamadas. */
+void conta_conclusao(const solucao_empilhamento* s, void* dados)
+{
+    (void) s;
+    (*(int*) dados)++;
+} // fim da função conta_conclusao
+
+
+/* Verifica se a solução s tem o valor de referência e uma pilha válida para o problema p,
+ * exibindo uma mensagem em caso de falha. Retorna o número de falhas (0 ou 1).
+ */
+int confere_solucao(problema p, const char* nome, const char* modo, const solucao_empilhamento* s, int referencia)
+{
+    if (s->valor == referencia && verifica_pilha(p, s->caixas, s->tam, s->valor))
+        return 0;
+
+    printf("FALHA: %s, %s: valor %d (%d caixas), esperado %d\n", nome, modo, s->valor, s->tam, referencia);
+    return 1;
+} // fim da função confere_solucao
+
+
+/* Confere os modos de uso da biblioteca na instância p, cujos dados estão em inst, comparando-os
+ * com a estratégia iterativa geral, cujo valor é gravado em referencia:
+ *
+ *      - as K melhores pilhas (resolve_k_melhores): a primeira tem o valor ótimo, as demais
+ *        têm valores não crescentes e todas são válidas;
+ *      - a resolução assíncrona pelo executor ex, aguardada e cancelada logo após a submissão:
+ *        a função de conclusão é chamada uma única vez e a tarefa cancelada termina com
+ *        RESOLUCAO_CANCELADA ou com o valor ótimo, se concluiu antes do pedido;
+ *      - o cache de soluções no diretório cache: a solução gravada é encontrada para uma cópia
+ *        da instância com as caixas embaralhadas, com a pilha na numeração da cópia;
+ *      - a estratégia em memória externa com pontos de verificação no arquivo checkpoint, sem
+ *        intervalo mínimo entre eles, interrompida na metade das linhas e retomada a partir do
+ *        último ponto de verificação.
+ *
+ * Retorna o número de falhas encontradas.
+ */
+int verifica_modos(problema p, const instancia_aleatoria* inst, const char* nome, executor ex,
+                   const char* cache, const char* checkpoint, unsigned long long* estado, int* referencia)
+{
+    int k, encontradas, conclusoes, valor = -1, falhas = 0; // Variáveis auxiliares.
+    opcoes_empilhamento opcoes; // Opções de resolução.
+    solucao_empilhamento solucao, melhores[MELHORES_PILHAS], copia_solucao; // Soluções.
+    acompanhamento_empilhamento acompanhamento; // Acompanhamento das tarefas assíncronas.
+    controle_resolucao controle; // Controle da resolução em memória externa interrompida.
+    problema copia; // Cópia embaralhada da instância.
+    tarefa t; // Tarefa assíncrona.
+    FILE* arq; // Arquivo de pontos de verificação.
+
+    inicializa_opcoes(&opcoes); // Referência: estratégia iterativa geral.
+    opcoes.especializar = 0;
+    *referencia = resolve_empilhamento(p, &opcoes, &solucao);
+    if (*referencia < 0) {
+        printf("FALHA: %s, bottom-up-geral: valor %d\n", nome, *referencia);
+        return 1;
+    }
+
+    // K melhores pilhas.
+    encontradas = resolve_k_melhores(p, MELHORES_PILHAS, melhores);
+    if (encontradas < 0 || (encontradas == 0) != (*referencia == 0)) {
+        printf("FALHA: %s, k-melhores: %d pilha(s), valor otimo %d\n", nome, encontradas, *referencia);
+        falhas++;
+    }
+    for(k = 0; k < encontradas; k++)
+        if (!verifica_pilha(p, melhores[k].caixas, melhores[k].tam, melhores[k].valor)
+            || melhores[k].valor > (k == 0 ? *referencia : melhores[k - 1].valor)
+            || (k == 0 && melhores[k].valor != *referencia)) {
+            printf("FALHA: %s, k-melhores: pilha %d com valor %d, valor otimo %d\n", nome, k + 1,
+                   melhores[k].valor, *referencia);
+            falhas++;
+        }
+    for(k = 0; k < MELHORES_PILHAS && encontradas >= 0; k++)
+        termina_solucao(&melhores[k]);
+
+    // Resolução assíncrona, aguardada até a conclusão.
+    conclusoes = 0;
+    acompanhamento.progresso = NULL;
+    acompanhamento.conclusao = conta_conclusao;
+    acompanhamento.dados = &conclusoes;
+    copia_solucao.caixas = NULL;
+    t = submete_empilhamento(ex, p, NULL, &acompanhamento);
+    if (!t || aguarda_empilhamento(t, &copia_solucao) < 0 || conclusoes != 1) {
+        printf("FALHA: %s, assincrono: tarefa nao concluida (%d conclusao(oes))\n", nome, conclusoes);
+        falhas++;
+    } else
+        falhas += confere_solucao(p, nome, "assincrono", &copia_solucao, *referencia);
+    termina_solucao(&copia_solucao);
+    if (t)
+        termina_tarefa(t);
+
+    // Resolução assíncrona cancelada logo após a submissão.
+    conclusoes = 0;
+    t = submete_empilhamento(ex, p, NULL, &acompanhamento);
+    if (t) {
+        cancela_empilhamento(t);
+        valor = aguarda_empilhamento(t, NULL);
+    }
+    if (!t || (valor != RESOLUCAO_CANCELADA && valor != *referencia) || conclusoes != 1) {
+        printf("FALHA: %s, assincrono cancelado: valor %d, %d conclusao(oes)\n", nome, t ? valor : -1, conclusoes);
+        falhas++;
+    }
+    if (t)
+        termina_tarefa(t);
+
+    // Cache de soluções, consultado com as caixas em outra ordem.
+    copia = embaralha_instancia(inst, estado);
+    copia_solucao.caixas = NULL;
+    if (!copia || !grava_cache(cache, 0, p, &solucao) || consulta_cache(cache, copia, &copia_solucao) != 1) {
+        printf("FALHA: %s, cache: solucao nao encontrada para a copia embaralhada\n", nome);
+        falhas++;
+    } else
+        falhas += confere_solucao(copia, nome, "cache", &copia_solucao, *referencia);
+    termina_solucao(&copia_solucao);
+    if (copia)
+        termina_problema(copia);
+    termina_solucao(&solucao);
+
+    // Estratégia em memória externa, interrompida após um ponto de verificação e retomada. Nas
+    // instâncias muito baixas, o primeiro acompanhamento é o da última linha, e elas não são usadas.
+    if (p->h < 2 * INTERVALO_CONTROLE)
+        return falhas;
+
+    inicializa_opcoes(&opcoes);
+    opcoes.motor = MOTOR_EXTERNO;
+    opcoes.externo.arquivo_checkpoint = checkpoint;
+    opcoes.externo.intervalo_checkpoint = 0; // O primeiro ponto de verificação é gravado na linha 1.
+    controle.cancelar = 0;
+    controle.progresso = interrompe_externo;
+    controle.dados = &controle;
+
+    p->controle = &controle;
+    valor = resolve_empilhamento(p, &opcoes, &solucao);
+    p->controle = NULL;
+    termina_solucao(&solucao);
+
+    arq = fopen(checkpoint, "rb");
+    if (valor != RESOLUCAO_CANCELADA || !arq) {
+        printf("FALHA: %s, externo: interrupcao sem ponto de verificacao (valor %d)\n", nome, valor);
+        falhas++;
+    }
+    if (arq)
+        fclose(arq);
+
+    opcoes.externo.retomar = 1;
+    resolve_empilhamento(p, &opcoes, &solucao);
+    falhas += confere_solucao(p, nome, "externo retomado", &solucao, *referencia);
+    termina_solucao(&solucao);
+
+    return falhas;
+} // fim da função verifica_modos
+
+
+/* Confere o processamento em lote: PROCESSOS_LOTE processos resolvem, com a função processa_lote,
+ * as instâncias gravadas no diretório (quantidade arquivos "aleatoria-<j>.data"), e o valor de cada
+ * arquivo .sol gerado é comparado com o esperado.
+ *
+ * Retorna o número de falhas encontradas.
+ */
+int verifica_lote(const char* diretorio, int quantidade, const int* esperados)
+{
+    int j, estado, valor, falhas = 0; // Variáveis auxiliares.
+    pid_t processos[PROCESSOS_LOTE]; // Processos que resolvem o lote.
+    opcoes_empilhamento opcoes; // Opções de resolução.
+    resumo_lote resumo; // Totais de cada processo.
+    char* nome = (char*) malloc(strlen(diretorio) + 32); // Arquivos de solução.
+
+    if (!nome) {
+        printf("ERRO: Problemas na alocação de memória.\n");
+        return 1;
+    }
+
+    inicializa_opcoes(&opcoes);
+    fflush(stdout); // Evita que os processos criados repitam a saída pendente.
+    for(j = 0; j < PROCESSOS_LOTE; j++) {
+        processos[j] = fork();
+        if (processos[j] == 0)
+            _exit(processa_lote(diretorio, &opcoes, 0, &resumo) < 0 || resumo.falhas > 0);
+    }
+
+    for(j = 0; j < PROCESSOS_LOTE; j++)
+        if (processos[j] < 0 || waitpid(processos[j], &estado, 0) != processos[j]
+            || !WIFEXITED(estado) || WEXITSTATUS(estado) != 0) {
+            printf("FALHA: lote: processo %d nao terminou normalmente\n", j + 1);
+            falhas++;
+        }
+
+    for(j = 0; j < quantidade; j++) {
+        sprintf(nome, "%s/aleatoria-%d.sol", diretorio, j);
+        valor = -1;
+        if (!le_valor_arquivo_saida(nome, &valor) || valor != esperados[j]) {
+            printf("FALHA: lote: %s com valor %d, esperado %d\n", nome, valor, esperados[j]);
+            falhas++;
+        }
+    }
+
+    free(nome);
+    return falhas;
+} // fim da função verifica_lote
+
+
+/* Resolve uma instância com cada estratégia selecionada (vetor de NUM_MOTORES + 1 posições, a
+ * última das quais é a estratégia iterativa geral, sem especialização, executada antes das demais
+ * para que sirva de referência na verificação). Se repeticoes é maior do que zero, as
+ * medições de tempo são exibidas. Se verificar é diferente de zero, cada pilha é validada e os
+ * valores obtidos são comparados entre as estratégias e com o valor esperado (se for não-negativo).
+ * Uma solução sem garantia de otimalidade (limitante maior do que o valor) é aceita se o valor de
+ * referência está entre o seu valor e o seu limitante, e não serve de referência para as demais.
+ * Os parâmetros threads e reduzir são repassados às opções de resolução.
+ *
+ * Retorna o número de falhas encontradas na verificação.
+ */
+int executa_instancia(problema p, const char* nome, const int* selecionados, int repeticoes,
+                      int threads, int reduzir, int verificar, int esperado, double* tempos)
+{
+    int j, k, r, falhas = 0, referencia = esperado; // Variáveis auxiliares.
+    double inicio; // Instante de início de uma execução.
+    const char* estrategia; // Nome da estratégia em execução.
+    opcoes_empilhamento opcoes; // Opções de resolução.
+    solucao_empilhamento solucao; // Solução de cada execução.
+
+    for(k = 0; k <= NUM_MOTORES; k++) { // Percorre as estratégias selecionadas, a geral primeiro.
+        j = (k == 0) ? BOTTOM_UP_GERAL : k - 1;
+        if (!selecionados[j])
+            continue;
+
+        inicializa_opcoes(&opcoes);
+        opcoes.motor = (j == BOTTOM_UP_GERAL) ? MOTOR_BOTTOM_UP : j;
+        opcoes.especializar = (j != BOTTOM_UP_GERAL);
+        opcoes.threads = threads;
+        opcoes.reduzir = reduzir;
+        estrategia = (j == BOTTOM_UP_GERAL) ? "bottom-up-geral" : nome_motor(j);
+
+        for(r = 0; r < repeticoes || r == 0; r++) {
+            if (r > 0)
+                termina_solucao(&solucao);
+
+            inicio = instante_atual();
+            resolve_empilhamento(p, &opcoes, &solucao);
+            tempos[r] = instante_atual() - inicio;
+        }
+
+        if (repeticoes > 0) {
+            qsort(tempos, repeticoes, sizeof(double), compara_tempo);
+            printf("%-28s %-18s %12d %12.4f %12.4f %12.4f %16lld\n", nome, estrategia, solucao.valor,
+                   tempos[0], tempos[repeticoes / 2], solucao.est.segundos_grafo, solucao.est.subproblemas);
+            fflush(stdout);
+        }
+
+        if (verificar) {
+            if (solucao.valor < 0 || !verifica_pilha(p, solucao.caixas, solucao.tam, solucao.valor)) {
+                printf("FALHA: %s, %s: pilha invalida (valor %d, %d caixas)\n", nome, estrategia,
+                       solucao.valor, solucao.tam);
+                falhas++;
+            } else if (solucao.limitante > solucao.valor) { // Solução aproximada.
+                if (referencia >= 0 && (solucao.valor > referencia || solucao.limitante < referencia)) {
+                    printf("FALHA: %s, %s: valor %d e limitante %d, esperado %d\n", nome, estrategia,
+                           solucao.valor, solucao.limitante, referencia);
+                    falhas++;
+                }
+            } else {
+                if (referencia >= 0 && solucao.valor != referencia) {
+                    printf("FALHA: %s, %s: valor %d, esperado %d\n", nome, estrategia, solucao.valor, referencia);
+                    falhas++;
+                }
+
+                if (referencia < 0) // O primeiro valor ótimo passa a ser a referência das demais estratégias.
+                    referencia = solucao.valor;
+            }
+        }
+
+        termina_solucao(&solucao);
+    }
+
+    return falhas;
+} // fim da função executa_instancia
+
+
+/* Função principal do programa auxiliar. A sintaxe de execução é:
+ *
+ * benchmark [-o] [-i] [-r] [-b] [-p] [-t] [-x] [-a] [-q] [-w] [-u] [-d] [-j <threads>] [-s] [-n <repeticoes>] [-v] <arquivo_entrada> [...]
+ * benchmark [-o] [-i] [-r] [-b] [-p] [-t] [-x] [-a] [-q] [-w] [-u] [-d] [-j <threads>] [-s] [-m <diretorio>] [-c <caixas>] -g <quantidade> <semente>
+ *
+ * Os parâmetros -o, -i, -r, -b, -p, -t, -x, -a, -q, -w, -u e -d selecionam, respectivamente, as estratégias iterativa
+ * geral (sem especialização para a instância), iterativa (bottom-up, com especialização), recursiva (top-down),
+ * branch and bound, periódica, recursiva paralela, iterativa em memória externa,
+ * anytime (sem prazo, isto é, até a otimalidade), aproximada (com o erro padrão), iterativa com janela de
+ * valores e predecessores compactos, iterativa indexada pelo valor e por degraus. Se nenhum deles é informado,
+ * todas as estratégias são executadas (a indexada pelo valor, nos arquivos de entrada, apenas se o
+ * limitante de valor da instância é menor do que a altura máxima). O parâmetro -j define o número
+ * de threads da estratégia paralela (padrão: uma por processador) e o parâmetro -n, o número de
+ * repetições de cada medição (padrão: 3).
+ * O parâmetro -s desabilita a redução das instâncias antes da resolução.
+ *
+ * Para cada instância e estratégia é exibida uma linha com o valor da solução, o menor tempo,
+ * a mediana dos tempos, o tempo de construção da relação de empilhamento da última execução
+ * (incluído nos anteriores), em segundos, e o número de subproblemas avaliados.
+ *
+ * O parâmetro -v ativa a verificação: cada pilha é validada e os valores das estratégias são
+ * comparados entre si e com o arquivo .sol de mesmo nome da instância, se existir. O parâmetro
+ * -g substitui os arquivos de entrada por uma quantidade de instâncias aleatórias, geradas a
+ * partir da semente informada, e sempre ativa a verificação (sem medições de tempo). O parâmetro
+ * -c define o número máximo de caixas dessas instâncias (padrão: CAIXAS_ALEATORIAS_PADRAO; até
+ * MAXIMO_CAIXAS_ALEATORIAS, para que as linhas de 128 e 256 bits de pequeno.c sejam exercitadas).
+ *
+ * Com -g, o parâmetro -m confere também, em cada instância aleatória, os modos de uso da biblioteca
+ * (função verifica_modos: K melhores pilhas, resolução assíncrona e cancelada, cache com as caixas
+ * embaralhadas e a retomada da estratégia em memória externa)
+ * e, ao final, o processamento em lote das instâncias por PROCESSOS_LOTE processos (função
+ * verifica_lote). Os arquivos de trabalho ficam no diretório informado, criado se não existir.
+ *
+ * Retorna 0 (zero) se nenhuma falha de verificação foi encontrada ou 1 (um), caso contrário.
+ */
+int main(int argc, char* argv[])
+{
+    int i = 1, j, repeticoes = 3, selecionados[NUM_MOTORES + 1], algum = 0; // Variáveis auxiliares.
+    int verificar = 0, aleatorias = 0, esperado, falhas = 0, threads = 0, reduzir = 1; // Variáveis auxiliares.
+    int caixas = CAIXAS_ALEATORIAS_PADRAO; // Número máximo de caixas das instâncias aleatórias.
+    unsigned long long semente = 0; // Estado do gerador de instâncias aleatórias.
+    char nome[64], *nome_sol; // Nomes de instâncias e de arquivos .sol.
+    double *tempos; // Tempos das repetições.
+    problema p; // Instância em execução.
+    instancia_aleatoria inst; // Dados da instância aleatória em execução.
+
+    // Verificação dos modos de uso (parâmetro -m): diretórios e arquivos de trabalho, executor
+    // das tarefas assíncronas e valores esperados das instâncias do lote.
+    const char* diretorio_modos = NULL;
+    char *cache = NULL, *checkpoint = NULL, *lote = NULL, *nome_lote = NULL;
+    executor ex = NULL;
+    int* esperados = NULL;
+
+    for(j = 0; j <= NUM_MOTORES; j++)
+        selecionados[j] = 0;
+
+    // Processamento dos parâmetros opcionais.
+    for(; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-o") == 0)
+            selecionados[BOTTOM_UP_GERAL] = algum = 1;
+        else if (strcmp(argv[i], "-i") == 0)
+            selecionados[MOTOR_BOTTOM_UP] = algum = 1;
+        else if (strcmp(argv[i], "-r") == 0)
+            selecionados[MOTOR_TOP_DOWN] = algum = 1;
+        else if (strcmp(argv[i], "-b") == 0)
+            selecionados[MOTOR_BRANCH_AND_BOUND] = algum = 1;
+        else if (strcmp(argv[i], "-p") == 0)
+            selecionados[MOTOR_PERIODICO] = algum = 1;
+        else if (strcmp(argv[i], "-t") == 0)
+            selecionados[MOTOR_PARALELO] = algum = 1;
+        else if (strcmp(argv[i], "-x") == 0)
+            selecionados[MOTOR_EXTERNO] = algum = 1;
+        else if (strcmp(argv[i], "-a") == 0)
+            selecionados[MOTOR_ANYTIME] = algum = 1;
+        else if (strcmp(argv[i], "-q") == 0)
+            selecionados[MOTOR_APROXIMADO] = algum = 1;
+        else if (strcmp(argv[i], "-w") == 0)
+            selecionados[MOTOR_JANELA] = algum = 1;
+        else if (strcmp(argv[i], "-u") == 0)
+            selecionados[MOTOR_VALOR] = algum = 1;
+        else if (strcmp(argv[i], "-d") == 0)
+            selecionados[MOTOR_DEGRAUS] = algum = 1;
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0
+                 && atoi(argv[i + 1]) <= MAXIMO_CAIXAS_ALEATORIAS)
+            caixas = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0)
+            reduzir = 0;
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            repeticoes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-v") == 0)
+            verificar = 1;
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+            diretorio_modos = argv[++i];
+        else if (strcmp(argv[i], "-g") == 0 && i + 2 < argc && atoi(argv[i + 1]) > 0) {
+            aleatorias = atoi(argv[++i]);
+            semente = strtoull(argv[++i], NULL, 10) | 1; // O estado do gerador não pode ser nulo.
+        } else {
+            printf("ERRO: Parametro \"%s\" invalido!\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (i >= argc && !aleatorias) {
+        printf("ERRO: Ausencia de parametros!\n");
+        return 1;
+    }
+
+    if (!algum) // Sem seleção explícita, todas as estratégias são executadas.
+        for(j = 0; j <= NUM_MOTORES; j++)
+            selecionados[j] = 1;
+
+    tempos = (double*) malloc(sizeof(double) * repeticoes);
+    if (!tempos) {
+        printf("ERRO: Problemas na alocação de memória.\n");
+        return 1;
+    }
+
+    if (aleatorias) { // Modo diferencial, com instâncias aleatórias.
+        if (diretorio_modos) {
+            cache = (char*) malloc(strlen(diretorio_modos) + 16);
+            checkpoint = (char*) malloc(strlen(diretorio_modos) + 16);
+            lote = (char*) malloc(strlen(diretorio_modos) + 16);
+            nome_lote = (char*) malloc(strlen(diretorio_modos) + 48);
+            esperados = (int*) malloc(sizeof(int) * aleatorias);
+            ex = cria_executor(2, 0);
+            if (!cache || !checkpoint || !lote || !nome_lote || !esperados || !ex) {
+                printf("ERRO: Problemas na alocação de memória.\n");
+                aleatorias = 0;
+                falhas++;
+            } else {
+                sprintf(cache, "%s/cache", diretorio_modos);
+                sprintf(checkpoint, "%s/checkpoint", diretorio_modos);
+                sprintf(lote, "%s/lote", diretorio_modos);
+                mkdir(diretorio_modos, 0777); // Se os diretórios já existem, nada é feito.
+                mkdir(lote, 0777);
+            }
+        }
+
+        for(j = 0; j < aleatorias; j++) {
+            p = gera_instancia_aleatoria(&semente, caixas, &inst);
+            if (!p) {
+                printf("ERRO: Problemas na alocação de memória.\n");
+                falhas++;
+                break;
+            }
+
+            sprintf(nome, "aleatoria-%d", j);
+            falhas += executa_instancia(p, nome, selecionados, 0, threads, reduzir, 1, -1, tempos);
+
+            if (diretorio_modos) { // Modos de uso e gravação da instância no diretório do lote.
+                falhas += verifica_modos(p, &inst, nome, ex, cache, checkpoint, &semente, &esperados[j]);
+                sprintf(nome_lote, "%s/%s.sol", lote, nome);
+                remove(nome_lote); // Solução de uma execução anterior.
+                sprintf(nome_lote, "%s/%s.data", lote, nome);
+                if (!grava_instancia(nome_lote, &inst)) {
+                    printf("ERRO: Problemas na gravação do arquivo \"%s\".\n", nome_lote);
+                    falhas++;
+                }
+            }
+
+            termina_problema(p);
+        }
+
+        if (diretorio_modos && j == aleatorias && aleatorias > 0)
+            falhas += verifica_lote(lote, aleatorias, esperados);
+
+        printf("%d instancias aleatorias verificadas, %d falha(s).\n", j, falhas);
+        if (ex)
+            termina_executor(ex);
+        free(cache);
+        free(checkpoint);
+        free(lote);
+        free(nome_lote);
+        free(esperados);
+        free(tempos);
+        return (falhas > 0);
+    }
+
+    printf("%-28s %-18s %12s %12s %12s %12s %16s\n", "instancia", "estrategia", "valor", "t_min(s)", "t_mediana(s)",
+           "t_grafo(s)", "subproblemas");
+
+    for(; i < argc; i++) { // Percorre as instâncias.
+        p = processa_arquivo_entrada(argv[i]);
+
+        if (!p) {
+            printf("ERRO: Problemas na abertura/leitura/processamento do arquivo \"%s\".\n", argv[i]);
+            falhas++;
+            continue;
+        }
+
+        esperado = -1; // Valor esperado, lido do arquivo .sol da instância, se existir.
+        if (verificar && strlen(argv[i]) > 5 && strcmp(argv[i] + strlen(argv[i]) - 5, ".data") == 0) {
+            nome_sol = (char*) malloc(strlen(argv[i]) + 1);
+            if (nome_sol) {
+                strcpy(nome_sol, argv[i]);
+                strcpy(nome_sol + strlen(nome_sol) - 5, ".sol");
+                if (!le_valor_arquivo_saida(nome_sol, &esperado))
+                    esperado = -1;
+                free(nome_sol);
+            }
+        }
+
+        // Sem seleção explícita, a estratégia indexada pelo valor só é executada quando é a preferível
+        // (limitante de valor menor do que a altura): nas demais instâncias, a sua tabela é enorme.
+        if (!algum)
+            selecionados[MOTOR_VALOR] = (limite_valor(p) < p->h);
+
+        falhas += executa_instancia(p, argv[i], selecionados, repeticoes, threads, reduzir, verificar, esperado, tempos);
+
+        termina_problema(p);
+    }
+
+    if (verificar)
+        printf("%d falha(s) de verificacao.\n", falhas);
+
+    free(tempos);
+    return (falhas > 0);
+} // fim da função main
@@ -0,0 +1,406 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "cache.h"
+
+/* Cache de soluções em disco, endereçado pelo conteúdo da instância. Instâncias iguais a menos da
+ * ordem das caixas (ou das rotações) têm a mesma forma canônica: as rotações (l, a, p, v) em
+ * ordem lexicográfica, acompanhadas de h. O resumo (hash FNV-1a de 64 bits) da forma canônica dá
+ * nome à entrada do cache, um arquivo "<resumo>.emp" no diretório do cache, que guarda a forma
+ * canônica completa (para descartar colisões do resumo), o valor ótimo e a pilha, com os índices
+ * das rotações na ordem canônica. Em um acerto, a pilha é convertida para a numeração de caixas
+ * do problema consultado, sem nenhuma programação dinâmica.
+ *
+ * As entradas são gravadas em um arquivo auxiliar que então as substitui, de modo que processos
+ * simultâneos nunca leem entradas incompletas. O tamanho do diretório é limitado: após cada
+ * gravação, as entradas usadas há mais tempo são removidas até que o total caiba no limite. Cada
+ * acerto atualiza a data de modificação da entrada, que serve, assim, como data do último uso.
+ */
+
+#define MAGICA_CACHE "EMPCACH1" // Identificação das entradas do cache.
+#define EXTENSAO_CACHE ".emp" // Extensão dos arquivos de entradas do cache.
+
+/* Cabeçalho de uma entrada do cache, seguido das n rotações canônicas (l, a, p, v) e da pilha. */
+typedef struct {
+    char magica[8]; // Identificação do arquivo (MAGICA_CACHE, sem o '\0').
+    int n, h; // Dimensões do problema.
+    int valor; // Valor ótimo.
+    int tam; // Tamanho da pilha.
+} cabecalho_cache;
+
+/* Entrada do diretório do cache, para a remoção das usadas há mais tempo. */
+typedef struct {
+    char* nome; // Caminho do arquivo.
+    struct timespec uso; // Data do último uso (data de modificação do arquivo).
+    off_t tamanho; // Tamanho do arquivo, em bytes.
+} entrada_cache;
+
+
+/* Compara duas rotações canônicas pelas dimensões e pelo valor (ordem lexicográfica de l, a, p e
+ * v), para ordenação com a função qsort. */
+int compara_rotacao_canonica(const void* x, const void* y)
+{
+    const rotacao_canonica *r = (const rotacao_canonica*) x, *s = (const rotacao_canonica*) y;
+
+    if (r->l != s->l)
+        return (r->l > s->l) - (r->l < s->l);
+    if (r->a != s->a)
+        return (r->a > s->a) - (r->a < s->a);
+    if (r->p != s->p)
+        return (r->p > s->p) - (r->p < s->p);
+    return (r->v > s->v) - (r->v < s->v);
+} // fim da função compara_rotacao_canonica
+
+
+/* Compara duas entradas do cache pela data do último uso (mais antigas primeiro), para ordenação
+ * com a função qsort. */
+int compara_uso_cache(const void* x, const void* y)
+{
+    const entrada_cache *e = (const entrada_cache*) x, *f = (const entrada_cache*) y;
+
+    if (e->uso.tv_sec != f->uso.tv_sec)
+        return (e->uso.tv_sec > f->uso.tv_sec) - (e->uso.tv_sec < f->uso.tv_sec);
+    return (e->uso.tv_nsec > f->uso.tv_nsec) - (e->uso.tv_nsec < f->uso.tv_nsec);
+} // fim da função compara_uso_cache
+
+
+/* Cria a forma canônica do problema: o vetor das n rotações, em ordem lexicográfica de (l, a, p,
+ * v), cada uma com o seu índice no problema.
+ *
+ * Retorna o vetor ou NULL, em caso de falha na alocação de memória.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n log n)
+ */
+rotacao_canonica* forma_canonica(problema p)
+{
+    rotacao_canonica* rotacoes; // Vetor que será retornado pela função.
+    int i; // Variável auxiliar.
+
+    rotacoes = (rotacao_canonica*) malloc(sizeof(rotacao_canonica) * (p->n + 1));
+    if (rotacoes) {
+        for(i = 0; i < p->n; i++) {
+            rotacoes[i].l = p->caixas[i].l;
+            rotacoes[i].a = p->caixas[i].a;
+            rotacoes[i].p = p->caixas[i].p;
+            rotacoes[i].v = p->v[i];
+            rotacoes[i].indice = i;
+        }
+        qsort(rotacoes, p->n, sizeof(rotacao_canonica), compara_rotacao_canonica);
+    }
+
+    return rotacoes; // Retorna o vetor criado ou NULL.
+} // fim da função forma_canonica
+
+
+/* Calcula o resumo (hash FNV-1a de 64 bits) da forma canônica do problema p: n, h e as rotações
+ * canônicas, sem os seus índices.
+ *
+ * Complexidade: O(n)
+ */
+unsigned long long resumo_canonico(problema p, const rotacao_canonica* rotacoes)
+{
+    unsigned long long resumo = 14695981039346656037ULL; // Base do FNV-1a.
+    int i, k, dados[4]; // Variáveis auxiliares.
+    const unsigned char* byte; // Bytes em processamento.
+
+    for(i = -1; i < p->n; i++) {
+        if (i < 0) { // Primeiro, as dimensões do problema.
+            dados[0] = p->n;
+            dados[1] = p->h;
+            dados[2] = dados[3] = 0;
+        } else {
+            dados[0] = rotacoes[i].l;
+            dados[1] = rotacoes[i].a;
+            dados[2] = rotacoes[i].p;
+            dados[3] = rotacoes[i].v;
+        }
+
+        byte = (const unsigned char*) dados;
+        for(k = 0; k < (int) sizeof(dados); k++) {
+            resumo ^= byte[k];
+            resumo *= 1099511628211ULL; // Primo do FNV-1a.
+        }
+    }
+
+    return resumo;
+} // fim da função resumo_canonico
+
+
+/* Retorna o caminho da entrada do cache de resumo informado, no diretório do cache, acrescido do
+ * sufixo informado, ou NULL em caso de falha na alocação de memória.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(1)
+ */
+char* nome_entrada_cache(const char* diretorio, unsigned long long resumo, const char* sufixo)
+{
+    char* nome = (char*) malloc(strlen(diretorio) + strlen(sufixo) + 32); // Caminho da entrada.
+
+    if (nome)
+        sprintf(nome, "%s/%016llx%s%s", diretorio, resumo, EXTENSAO_CACHE, sufixo);
+
+    return nome;
+} // fim da função nome_entrada_cache
+
+
+/* Inicializa a solução s como vazia (valor -1, sem pilha e sem contadores).
+ *
+ * Complexidade: O(1)
+ */
+void inicializa_solucao_cache(solucao_empilhamento* s)
+{
+    s->valor = s->limitante = -1;
+    s->caixas = NULL;
+    s->tam = 0;
+    s->est.subproblemas = 0;
+    s->est.transicoes = 0;
+    s->est.segundos_grafo = 0;
+    s->est.caixas_eliminadas = 0;
+    s->est.tipo_paginas = 0;
+    s->est.falhas_tlb = -1;
+    s->est.fracao_remota = -1;
+} // fim da função inicializa_solucao_cache
+
+
+/* Consulta o cache do diretório informado: procura a entrada da forma canônica do problema p e,
+ * se ela existe e corresponde exatamente à instância, preenche a solução s com o valor ótimo e a
+ * pilha, na numeração de caixas de p, e marca a entrada como usada. A pilha é ainda validada
+ * (função verifica_pilha); entradas inválidas são tratadas como ausentes.
+ *
+ * Retorna 1 (um) em caso de acerto, 0 (zero) se a instância não está no cache ou -1 em caso de
+ * falha na alocação de memória. Nos dois últimos casos, s recebe o valor -1 e nenhuma pilha.
+ *
+ * Obs.: Em caso de acerto, a pilha deve ser liberada posteriormente com a função termina_solucao.
+ *
+ * Complexidade: O(n log n + tam)
+ */
+int consulta_cache(const char* diretorio, problema p, solucao_empilhamento* s)
+{
+    rotacao_canonica *rotacoes, *lidas = NULL; // Formas canônicas do problema e da entrada.
+    cabecalho_cache cab; // Cabeçalho da entrada.
+    char *nome; // Caminho da entrada.
+    FILE *arq; // Arquivo da entrada.
+    int i, j, acerto = 0; // Variáveis auxiliares.
+
+    inicializa_solucao_cache(s);
+
+    rotacoes = forma_canonica(p);
+    if (!rotacoes)
+        return -1; // Falha, devido à ausência de recursos computacionais.
+
+    nome = nome_entrada_cache(diretorio, resumo_canonico(p, rotacoes), "");
+    if (!nome) {
+        free(rotacoes);
+        return -1; // Falha, devido à ausência de recursos computacionais.
+    }
+
+    arq = fopen(nome, "rb");
+    if (arq) {
+        if (fread(&cab, sizeof(cabecalho_cache), 1, arq) == 1 &&
+                memcmp(cab.magica, MAGICA_CACHE, sizeof(cab.magica)) == 0 &&
+                cab.n == p->n && cab.h == p->h && cab.tam >= 0 && cab.tam <= p->h + 1) {
+
+            lidas = (rotacao_canonica*) malloc(sizeof(rotacao_canonica) * (p->n + 1));
+            s->caixas = (int*) malloc(sizeof(int) * (cab.tam + 1));
+
+            if (lidas && s->caixas) {
+                acerto = 1;
+
+                // A forma canônica gravada deve ser idêntica à do problema (sem colisão do resumo).
+                for(i = 0; i < p->n && acerto; i++)
+                    acerto = fread(&lidas[i], sizeof(int), 4, arq) == 4 &&
+                             compara_rotacao_canonica(&lidas[i], &rotacoes[i]) == 0;
+
+                // Pilha gravada na ordem canônica, convertida para os índices de p.
+                for(s->tam = 0; s->tam < cab.tam && acerto; s->tam++) {
+                    acerto = fread(&j, sizeof(int), 1, arq) == 1 && j >= 0 && j < p->n;
+                    if (acerto)
+                        s->caixas[s->tam] = rotacoes[j].indice;
+                }
+
+                acerto = acerto && verifica_pilha(p, s->caixas, s->tam, cab.valor);
+            } else
+                acerto = -1; // Falha, devido à ausência de recursos computacionais.
+        }
+        fclose(arq);
+    }
+
+    if (acerto == 1) {
+        s->valor = s->limitante = cab.valor;
+        if (s->tam == 0) { // A pilha vazia é representada sem vetor.
+            free(s->caixas);
+            s->caixas = NULL;
+        }
+        utimensat(AT_FDCWD, nome, NULL, 0); // A data de modificação registra o último uso.
+    } else {
+        free(s->caixas);
+        s->caixas = NULL;
+        s->tam = 0;
+    }
+
+    free(lidas);
+    free(nome);
+    free(rotacoes);
+
+    return acerto; // Retorna 1 (acerto), 0 (ausente) ou -1 (falha).
+} // fim da função consulta_cache
+
+
+/* Remove as entradas do diretório do cache usadas há mais tempo, até que o tamanho total das
+ * entradas não exceda limite bytes. A entrada de caminho preservar (se não for NULL), recém-gravada,
+ * nunca é removida.
+ *
+ * Retorna o número de entradas removidas, ou -1 se o diretório não pôde ser lido.
+ *
+ * Complexidade: O(m log m), em que m é o número de entradas do cache.
+ */
+int limita_cache(const char* diretorio, double limite, const char* preservar)
+{
+    DIR *dir; // Diretório do cache.
+    struct dirent *item; // Item do diretório.
+    struct stat info; // Informações de um arquivo.
+    entrada_cache *entradas = NULL, *aux; // Entradas encontradas.
+    int num_entradas = 0, capacidade = 0, removidas = 0, i; // Variáveis auxiliares.
+    size_t tam_nome; // Tamanho do nome de um item.
+    double total = 0; // Tamanho total das entradas.
+    char *nome; // Caminho de um item.
+
+    dir = opendir(diretorio);
+    if (!dir)
+        return -1;
+
+    while ((item = readdir(dir)) != NULL) {
+        tam_nome = strlen(item->d_name);
+        if (tam_nome <= strlen(EXTENSAO_CACHE) ||
+                strcmp(item->d_name + tam_nome - strlen(EXTENSAO_CACHE), EXTENSAO_CACHE) != 0)
+            continue; // Não é uma entrada do cache (inclusive os arquivos auxiliares).
+
+        nome = (char*) malloc(strlen(diretorio) + tam_nome + 2);
+        if (!nome)
+            break;
+        sprintf(nome, "%s/%s", diretorio, item->d_name);
+
+        if (stat(nome, &info) != 0 || !S_ISREG(info.st_mode)) {
+            free(nome);
+            continue;
+        }
+
+        if (num_entradas == capacidade) { // Amplia o vetor de entradas, dobrando a sua capacidade.
+            capacidade = (capacidade > 0) ? 2 * capacidade : 64;
+            aux = (entrada_cache*) realloc(entradas, sizeof(entrada_cache) * capacidade);
+            if (!aux) {
+                free(nome);
+                break;
+            }
+            entradas = aux;
+        }
+
+        entradas[num_entradas].nome = nome;
+        entradas[num_entradas].uso = info.st_mtim;
+        entradas[num_entradas].tamanho = info.st_size;
+        total += (double) info.st_size;
+        num_entradas++;
+    }
+    closedir(dir);
+
+    // Remove as entradas usadas há mais tempo, até que o total caiba no limite.
+    if (total > limite && num_entradas > 0) {
+        qsort(entradas, num_entradas, sizeof(entrada_cache), compara_uso_cache);
+        for(i = 0; i < num_entradas && total > limite; i++)
+            if ((!preservar || strcmp(entradas[i].nome, preservar) != 0) && remove(entradas[i].nome) == 0) {
+                total -= (double) entradas[i].tamanho;
+                removidas++;
+            }
+    }
+
+    for(i = 0; i < num_entradas; i++)
+        free(entradas[i].nome);
+    free(entradas);
+
+    return removidas;
+} // fim da função limita_cache
+
+
+/* Grava no cache do diretório informado (criado, se não existe) a solução s (ótima) do problema
+ * p, com a pilha na ordem canônica, e remove as entradas usadas há mais tempo até que o diretório não exceda limite bytes
+ * (se limite for menor ou igual a zero, usa-se TAMANHO_CACHE_PADRAO). Soluções não comprovadamente
+ * ótimas (limitante diferente do valor) não são gravadas.
+ *
+ * Retorna 1 (um) em caso de sucesso ou 0 (zero), caso contrário.
+ *
+ * Complexidade: O(n log n + tam), além da limpeza do diretório.
+ */
+int grava_cache(const char* diretorio, double limite, problema p, const solucao_empilhamento* s)
+{
+    rotacao_canonica *rotacoes; // Forma canônica do problema.
+    cabecalho_cache cab; // Cabeçalho da entrada.
+    unsigned long long resumo; // Resumo da forma canônica.
+    char *nome, *nome_tmp, sufixo[32]; // Caminhos da entrada e do arquivo auxiliar.
+    int *posicao, i, sucesso = 0; // Posição de cada rotação na ordem canônica e variáveis auxiliares.
+    FILE *arq; // Arquivo auxiliar.
+
+    if (s->valor < 0 || s->limitante != s->valor)
+        return 0; // Apenas soluções ótimas são gravadas.
+
+    if (limite <= 0)
+        limite = TAMANHO_CACHE_PADRAO;
+
+    rotacoes = forma_canonica(p);
+    posicao = (int*) malloc(sizeof(int) * (p->n + 1));
+    if (!rotacoes || !posicao) {
+        free(rotacoes);
+        free(posicao);
+        return 0; // Falha, devido à ausência de recursos computacionais.
+    }
+
+    for(i = 0; i < p->n; i++)
+        posicao[rotacoes[i].indice] = i;
+
+    mkdir(diretorio, 0777); // Se o diretório já existe, nada é feito.
+
+    resumo = resumo_canonico(p, rotacoes);
+    sprintf(sufixo, ".tmp%ld", (long) getpid()); // Arquivo auxiliar próprio de cada processo.
+    nome = nome_entrada_cache(diretorio, resumo, "");
+    nome_tmp = nome_entrada_cache(diretorio, resumo, sufixo);
+
+    if (nome && nome_tmp && (arq = fopen(nome_tmp, "wb")) != NULL) {
+        memcpy(cab.magica, MAGICA_CACHE, sizeof(cab.magica));
+        cab.n = p->n;
+        cab.h = p->h;
+        cab.valor = s->valor;
+        cab.tam = s->tam;
+
+        sucesso = fwrite(&cab, sizeof(cabecalho_cache), 1, arq) == 1;
+        for(i = 0; i < p->n && sucesso; i++)
+            sucesso = fwrite(&rotacoes[i], sizeof(int), 4, arq) == 4;
+        for(i = 0; i < s->tam && sucesso; i++)
+            sucesso = fwrite(&posicao[s->caixas[i]], sizeof(int), 1, arq) == 1;
+
+        sucesso = (fclose(arq) == 0) && sucesso;
+        sucesso = sucesso && rename(nome_tmp, nome) == 0;
+        if (!sucesso)
+            remove(nome_tmp);
+    }
+
+    if (sucesso)
+        limita_cache(diretorio, limite, nome);
+
+    free(nome);
+    free(nome_tmp);
+    free(rotacoes);
+    free(posicao);
+
+    return sucesso;
+} // fim da função grava_cache
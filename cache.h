@@ -0,0 +1,23 @@
+#ifndef CACHE_H_INCLUDED
+#define CACHE_H_INCLUDED
+
+#include "empilhamento.h"
+
+/* Tamanho máximo padrão do diretório de cache, em bytes. */
+#define TAMANHO_CACHE_PADRAO (64.0 * 1024 * 1024)
+
+/* Rotação de caixa na forma canônica do problema: dimensões, valor e índice no problema. */
+typedef struct {
+    int l, a, p, v; // Largura, altura, profundidade e valor.
+    int indice; // Índice da rotação no problema (não faz parte da forma canônica).
+} rotacao_canonica;
+
+rotacao_canonica* forma_canonica(problema);
+
+unsigned long long resumo_canonico(problema, const rotacao_canonica*);
+
+int consulta_cache(const char*, problema, solucao_empilhamento*);
+
+int grava_cache(const char*, double, problema, const solucao_empilhamento*);
+
+#endif // CACHE_H_INCLUDED
@@ -0,0 +1,414 @@
+#include <stdlib.h>
+#include "degraus.h"
+#include "perfil.h"
+
+/* Estratégia iterativa que representa, para cada caixa i da base, a função k -> matriz_emp[k][i]
+ * (o maior valor de uma pilha de altura até k com a caixa i na base) apenas pelos seus degraus.
+ *
+ * Essa função é não-decrescente e só muda nas alturas em que alguma pilha com base i passa a valer
+ * mais; entre dois degraus, as matrizes da estratégia iterativa repetem o mesmo valor e o mesmo
+ * predecessor em todas as linhas. Aqui, cada caixa guarda apenas a lista dos seus degraus, em ordem
+ * crescente de altura, cada um com a altura, o valor e o predecessor (a caixa empilhada sobre i).
+ *
+ * Como f_i(k) = v(i) + max { f_j(k - a(i)) : j sobre i }, os degraus de f_i estão nas alturas
+ * a(i) + d, em que d é um degrau de alguma f_j. Os degraus são então gerados em ordem crescente de
+ * altura, por eventos: cada novo degrau (d, valor) da caixa j propõe, a cada caixa i sob a qual j
+ * pode ser empilhada, o evento "na altura d + a(i), a caixa i vale v(i) + valor com j acima". Ao
+ * processar um evento, todos os degraus de altura menor já são definitivos (as alturas são
+ * positivas), e o evento só cria um degrau se superar o último valor da caixa.
+ *
+ * Como os degraus são processados em ordem crescente de altura, os eventos de cada caixa são
+ * propostos também em ordem crescente de altura e ficam em uma fila da própria caixa, da qual são
+ * descartados os que não superam o último evento pendente (em altura igual ou menor). Um heap de
+ * mínimo, com uma entrada por caixa de fila não vazia (a altura do seu primeiro evento), indica o
+ * próximo evento a processar.
+ *
+ * A memória utilizada é proporcional ao número de degraus e de eventos pendentes, e não a (h + 1)n:
+ * em instâncias com poucas alturas de pilha distintas (por exemplo, alturas múltiplas de um valor
+ * grande), a redução é de ordens de grandeza. No pior caso, cada célula é um degrau, e o número de
+ * eventos é o de empilhamentos examinados pela estratégia iterativa.
+ */
+
+/* Degrau da função de valor de uma caixa. */
+typedef struct {
+    int altura; // Menor altura em que o valor é alcançado.
+    int valor; // Valor da melhor pilha com a caixa na base, a partir dessa altura.
+    int predecessor; // Caixa empilhada sobre a da base (-1 se a pilha tem uma única caixa).
+} degrau;
+
+/* Evento: na altura informada, a caixa da fila pode valer v(caixa) + valor, com o predecessor acima. */
+typedef struct {
+    int altura; // Altura do evento.
+    int predecessor; // Caixa empilhada sobre a da fila (-1 se não houver).
+    int valor; // Valor da pilha com base no predecessor (0 se não houver).
+} evento_degrau;
+
+/* Fila de eventos pendentes de uma caixa, em ordem crescente de altura e de valor. */
+typedef struct {
+    evento_degrau* eventos; // Eventos (posições inicio a fim - 1).
+    int inicio, fim, capacidade; // Limites da fila e capacidade do vetor.
+} fila_degraus;
+
+/* Entrada do heap de caixas: a caixa e a altura do primeiro evento da sua fila. */
+typedef struct {
+    int altura; // Altura do primeiro evento pendente (chave do heap de mínimo).
+    int caixa; // Caixa.
+} entrada_degraus;
+
+
+/* Restaura a propriedade de heap de mínimo (pela altura) a partir da posição pos.
+ *
+ * Complexidade: O(log tam)
+ */
+void desce_heap_degraus(entrada_degraus* heap, int tam, int pos)
+{
+    entrada_degraus aux; // Variável auxiliar.
+    int filho; // Menor filho da posição atual.
+
+    for(filho = 2 * pos + 1; filho < tam; pos = filho, filho = 2 * pos + 1) {
+        if (filho + 1 < tam && heap[filho + 1].altura < heap[filho].altura)
+            filho++;
+        if (heap[pos].altura <= heap[filho].altura)
+            break;
+        aux = heap[pos];
+        heap[pos] = heap[filho];
+        heap[filho] = aux;
+    }
+} // fim da função desce_heap_degraus
+
+
+/* Restaura a propriedade de heap de mínimo (pela altura) a partir da posição pos, em direção à raiz.
+ *
+ * Complexidade: O(log pos)
+ */
+void sobe_heap_degraus(entrada_degraus* heap, int pos)
+{
+    entrada_degraus aux; // Variável auxiliar.
+
+    for(; pos > 0 && heap[(pos - 1) / 2].altura > heap[pos].altura; pos = (pos - 1) / 2) {
+        aux = heap[pos];
+        heap[pos] = heap[(pos - 1) / 2];
+        heap[(pos - 1) / 2] = aux;
+    }
+} // fim da função sobe_heap_degraus
+
+
+/* Acrescenta um evento ao final da fila de uma caixa, cuja última altura não pode ser maior do que a
+ * do evento. O evento é descartado se o último da fila já vale pelo menos o mesmo, e substitui o
+ * último se tem a mesma altura e vale mais. O vetor da fila é compactado ou ampliado quando está cheio.
+ *
+ * Retorna 1 (um) se a inserção foi bem sucedida (ou o evento foi descartado), ou 0 (zero) em caso de
+ * falha na alocação de memória.
+ *
+ * Complexidade: O(1), amortizada.
+ */
+int enfileira_evento_degrau(fila_degraus* f, evento_degrau e)
+{
+    evento_degrau *novo; // Variável auxiliar.
+    int i; // Variável auxiliar.
+
+    if (f->fim > f->inicio) {
+        if (f->eventos[f->fim - 1].valor >= e.valor)
+            return 1; // O evento é dominado pelo último da fila.
+        if (f->eventos[f->fim - 1].altura == e.altura) {
+            f->eventos[f->fim - 1] = e;
+            return 1;
+        }
+    }
+
+    if (f->fim == f->capacidade) {
+        if (f->inicio > f->capacidade / 2) { // Compacta a fila no início do vetor.
+            for(i = f->inicio; i < f->fim; i++)
+                f->eventos[i - f->inicio] = f->eventos[i];
+            f->fim -= f->inicio;
+            f->inicio = 0;
+        } else {
+            novo = (evento_degrau*) realloc(f->eventos, sizeof(evento_degrau) * (f->capacidade > 0 ? 2 * f->capacidade : 4));
+            if (!novo)
+                return 0; // Falha, devido à ausência de recursos computacionais.
+            f->eventos = novo;
+            f->capacidade = (f->capacidade > 0) ? 2 * f->capacidade : 4;
+        }
+    }
+
+    f->eventos[f->fim++] = e;
+    return 1;
+} // fim da função enfileira_evento_degrau
+
+
+/* Acrescenta um degrau ao final da lista de degraus de uma caixa, que é ampliada quando está cheia.
+ *
+ * Retorna 1 (um) se a inserção foi bem sucedida, ou 0 (zero) em caso de falha na alocação de memória.
+ *
+ * Complexidade: O(1), amortizada.
+ */
+int acrescenta_degrau(degrau** degraus, int* quantidade, int* capacidade, degrau d)
+{
+    degrau *novo; // Variável auxiliar.
+
+    if (*quantidade == *capacidade) {
+        novo = (degrau*) realloc(*degraus, sizeof(degrau) * (*capacidade > 0 ? 2 * *capacidade : 4));
+        if (!novo)
+            return 0; // Falha, devido à ausência de recursos computacionais.
+        *degraus = novo;
+        *capacidade = (*capacidade > 0) ? 2 * *capacidade : 4;
+    }
+
+    (*degraus)[(*quantidade)++] = d;
+    return 1;
+} // fim da função acrescenta_degrau
+
+
+/* Retorna a posição do último degrau de altura menor ou igual à altura informada, na lista de
+ * degraus (em ordem crescente de altura) de uma caixa, ou -1 se não houver.
+ *
+ * Complexidade: O(log quantidade)
+ */
+int busca_degrau(const degrau* degraus, int quantidade, int altura)
+{
+    int inicio = 0, fim = quantidade - 1, meio, pos = -1; // Variáveis auxiliares.
+
+    while (inicio <= fim) {
+        meio = inicio + (fim - inicio) / 2;
+        if (degraus[meio].altura <= altura) {
+            pos = meio;
+            inicio = meio + 1;
+        } else
+            fim = meio - 1;
+    }
+
+    return pos;
+} // fim da função busca_degrau
+
+
+/* Gera a pilha de caixas a partir das listas de degraus, para a altura máxima h e a caixa da base
+ * informadas: em cada nível, o degrau da caixa com a maior altura que não excede a altura restante
+ * indica a caixa seguinte e a altura que resta para ela.
+ *
+ * Retorna o vetor com a pilha e o seu tamanho, ou NULL e o tamanho 0 (zero) em caso de falha na
+ * alocação de memória ou se a caixa da base for inválida.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(t log d), em que t é o tamanho da pilha e d, o maior número de degraus de uma caixa.
+ */
+int* reconstroi_pilha_degraus(degrau** degraus, const int* quantidade, caixa* caixas, int n, int h, int base, int* tam)
+{
+    int *vetor, caixa_atual, altura, pos, num_caixas = 0; // Vetor que será retornado pela função e variáveis auxiliares.
+
+    *tam = 0; // O tamanho da pilha é inicializado com 0 (zero).
+
+    if (base < 0 || base >= n || h < 0) // Verifica se o subproblema é válido.
+        return NULL;
+
+    // Primeira passagem: conta as caixas da pilha.
+    for(caixa_atual = base, altura = h; caixa_atual != -1; num_caixas++) {
+        pos = busca_degrau(degraus[caixa_atual], quantidade[caixa_atual], altura);
+        if (pos == -1)
+            break;
+        altura = degraus[caixa_atual][pos].altura - caixas[caixa_atual].a;
+        caixa_atual = degraus[caixa_atual][pos].predecessor;
+    }
+
+    vetor = (int*) malloc(sizeof(int) * (num_caixas > 0 ? num_caixas : 1));
+
+    if (vetor) { // Verifica se a alocação foi bem sucedida.
+        // Segunda passagem: grava as caixas, da base para o topo.
+        for(caixa_atual = base, altura = h; caixa_atual != -1 && *tam < num_caixas; ) {
+            vetor[(*tam)++] = caixa_atual; // Insere a caixa na pilha.
+            pos = busca_degrau(degraus[caixa_atual], quantidade[caixa_atual], altura);
+            altura = degraus[caixa_atual][pos].altura - caixas[caixa_atual].a;
+            caixa_atual = degraus[caixa_atual][pos].predecessor;
+        }
+    }
+
+    return vetor; // Retorna o vetor criado ou NULL.
+} // fim da função reconstroi_pilha_degraus
+
+
+/* Encontra a solução ótima para o problema de empilhamento de caixas, utilizando a representação
+ * por degraus descrita no início do arquivo.
+ *
+ * Os parâmetros e os valores de retorno são os mesmos da função empilhamento_bottom_up. Os
+ * contadores de esforço registram o número de degraus criados (subproblemas) e de empilhamentos
+ * examinados ao propor eventos (transições).
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n² + Dg + E log n), em que D é o número de degraus, g o maior número de caixas
+ * sob as quais uma caixa pode ser empilhada e E o número de eventos processados.
+ */
+int empilhamento_degraus(problema p, int** vetor_de_caixas_empilhadas, int* tam)
+{
+    degrau **degraus = NULL, d; // Listas de degraus de cada caixa e degrau em construção.
+    int *quantidade = NULL, *capacidade = NULL; // Número de degraus e capacidade de cada lista.
+    int *inicio = NULL, *sob = NULL; // Caixas sob as quais cada caixa pode ser empilhada (relação inversa).
+    fila_degraus *filas = NULL; // Filas de eventos pendentes de cada caixa.
+    entrada_degraus *heap = NULL; // Heap de mínimo das caixas com eventos pendentes.
+    evento_degrau e, novo; // Evento em processamento e evento proposto.
+    int i, u, t, valor, ultimo, tam_heap = 0, altura = 0, alturas = 0, base = -1; // Variáveis auxiliares.
+    int falha = 0, cancelada = 0, solucao_otima = -1; // Variáveis auxiliares.
+    lista *vetor_lista_de_caixas_empilhaveis; // Listas de caixas empilháveis.
+    tipo_nodo *no; // Variável auxiliar utilizada para percorrer a lista de caixas empilháveis.
+
+    // Verifica se a variável passada como parâmetro representa memória alocada.
+    if (*vetor_de_caixas_empilhadas)
+        free(*vetor_de_caixas_empilhadas); // Libera a memória alocada.
+
+    *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
+    *tam = 0;                           // referência e que retornarão valores também.
+
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
+    vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p);
+    if (!vetor_lista_de_caixas_empilhaveis)
+        return -1; // Falha, devido à ausência de recursos computacionais.
+
+    degraus = (degrau**) calloc(p->n, sizeof(degrau*));
+    quantidade = (int*) calloc(p->n, sizeof(int));
+    capacidade = (int*) calloc(p->n, sizeof(int));
+    inicio = (int*) calloc(p->n + 1, sizeof(int));
+    filas = (fila_degraus*) calloc(p->n, sizeof(fila_degraus));
+    heap = (entrada_degraus*) malloc(sizeof(entrada_degraus) * (p->n > 0 ? p->n : 1));
+
+    if (degraus && quantidade && capacidade && inicio && filas && heap) {
+        // Relação inversa, em vetores contíguos: sob[inicio[j] .. inicio[j + 1] - 1] são as caixas
+        // sobre as quais a caixa j pode ser empilhada.
+        for(i = 0; i < p->n; i++)
+            for(no = vetor_lista_de_caixas_empilhaveis[i]->first; no; no = no->next)
+                inicio[no->item.chave + 1]++;
+        for(i = 0; i < p->n; i++)
+            inicio[i + 1] += inicio[i];
+
+        sob = (int*) malloc(sizeof(int) * (inicio[p->n] > 0 ? inicio[p->n] : 1));
+        if (sob)
+            for(i = 0; i < p->n; i++)
+                for(no = vetor_lista_de_caixas_empilhaveis[i]->first; no; no = no->next)
+                    sob[inicio[no->item.chave] + quantidade[no->item.chave]++] = i;
+    }
+
+    termina_vetor_lista_de_caixas_empilhaveis(vetor_lista_de_caixas_empilhaveis, p->n);
+
+    falha = !(degraus && quantidade && capacidade && inicio && filas && heap && sob);
+
+    if (!falha) {
+        for(i = 0; i < p->n; i++)
+            quantidade[i] = 0; // O vetor foi usado como cursor na construção da relação inversa.
+
+        // Eventos iniciais: cada caixa que cabe na pilha, sozinha.
+        inicia_fase(p, FASE_PROGRAMACAO);
+        for(i = 0; i < p->n && !falha; i++)
+            if (p->caixas[i].a > 0 && p->caixas[i].a <= p->h) {
+                novo.altura = p->caixas[i].a;
+                novo.predecessor = -1;
+                novo.valor = 0;
+                falha = !enfileira_evento_degrau(&filas[i], novo);
+                heap[tam_heap].altura = novo.altura;
+                heap[tam_heap].caixa = i;
+                sobe_heap_degraus(heap, tam_heap++);
+            }
+
+        while (tam_heap > 0 && !falha && !cancelada) {
+            // Retira o primeiro evento da caixa do topo do heap, que é o de menor altura.
+            i = heap[0].caixa;
+            e = filas[i].eventos[filas[i].inicio++];
+
+            if (filas[i].inicio < filas[i].fim)
+                heap[0].altura = filas[i].eventos[filas[i].inicio].altura;
+            else {
+                filas[i].inicio = filas[i].fim = 0;
+                heap[0] = heap[--tam_heap];
+            }
+            desce_heap_degraus(heap, tam_heap, 0);
+
+            // A cada INTERVALO_CONTROLE alturas distintas, informa o progresso e verifica se houve pedido de cancelamento.
+            if (e.altura != altura) {
+                altura = e.altura;
+                if (++alturas % INTERVALO_CONTROLE == 0)
+                    cancelada = acompanha_resolucao(p, altura, p->h);
+            }
+
+            valor = p->v[i] + e.valor;
+            ultimo = quantidade[i] - 1;
+
+            if (valor <= ((ultimo >= 0) ? degraus[i][ultimo].valor : 0))
+                continue; // O evento não melhora a caixa.
+
+            if (ultimo >= 0 && degraus[i][ultimo].altura == altura) { // Melhora o degrau desta altura.
+                degraus[i][ultimo].valor = valor;
+                degraus[i][ultimo].predecessor = e.predecessor;
+            } else { // Cria um degrau.
+                d.altura = altura;
+                d.valor = valor;
+                d.predecessor = e.predecessor;
+                falha = !acrescenta_degrau(&degraus[i], &quantidade[i], &capacidade[i], d);
+                p->est.subproblemas++;
+            }
+
+            // O novo valor pode melhorar as caixas sob as quais a caixa i pode ser empilhada.
+            p->est.transicoes += inicio[i + 1] - inicio[i];
+            for(t = inicio[i]; t < inicio[i + 1] && !falha; t++) {
+                u = sob[t];
+                if (p->caixas[u].a > p->h - altura) // A pilha não cabe na altura máxima.
+                    continue;
+                if (quantidade[u] > 0 && degraus[u][quantidade[u] - 1].valor >= p->v[u] + valor)
+                    continue; // A caixa u já vale pelo menos isso, em uma altura menor.
+
+                novo.altura = altura + p->caixas[u].a;
+                novo.predecessor = i;
+                novo.valor = valor;
+
+                if (filas[u].inicio == filas[u].fim) { // A caixa passa a ter eventos pendentes.
+                    heap[tam_heap].altura = novo.altura;
+                    heap[tam_heap].caixa = u;
+                    sobe_heap_degraus(heap, tam_heap++);
+                }
+                falha = !enfileira_evento_degrau(&filas[u], novo);
+            }
+        }
+        encerra_fase(p, FASE_PROGRAMACAO);
+
+        if (falha)
+            solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
+        else if (cancelada && tam_heap > 0) // Resolução interrompida: não há solução.
+            solucao_otima = RESOLUCAO_CANCELADA;
+        else {
+            // A solução ótima é o maior valor final dentre as caixas (o último degrau de cada uma).
+            solucao_otima = 0;
+            for(i = 0; i < p->n; i++)
+                if (quantidade[i] > 0 && degraus[i][quantidade[i] - 1].valor > solucao_otima) {
+                    solucao_otima = degraus[i][quantidade[i] - 1].valor;
+                    base = i;
+                }
+
+            if (solucao_otima > 0) { // Se a variável é maior do que 0 (zero), uma solução ótima foi encontrada.
+                inicia_fase(p, FASE_RECONSTRUCAO);
+                (*vetor_de_caixas_empilhadas) = reconstroi_pilha_degraus(degraus, quantidade, p->caixas, p->n, p->h, base, tam);
+                encerra_fase(p, FASE_RECONSTRUCAO);
+
+                if (!(*vetor_de_caixas_empilhadas)) // Verifica se a alocação foi bem sucedida.
+                    solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
+            }
+        }
+    }
+
+    // Libera todos os recursos alocados.
+    for(i = 0; i < p->n; i++) {
+        if (degraus)
+            free(degraus[i]);
+        if (filas)
+            free(filas[i].eventos);
+    }
+    free(degraus);
+    free(quantidade);
+    free(capacidade);
+    free(inicio);
+    free(sob);
+    free(filas);
+    free(heap);
+
+    return solucao_otima; // Retorna a solução ótima, -1 ou RESOLUCAO_CANCELADA.
+} // fim da função empilhamento_degraus
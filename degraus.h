@@ -0,0 +1,8 @@
+#ifndef DEGRAUS_H_INCLUDED
+#define DEGRAUS_H_INCLUDED
+
+#include "estruturas.h"
+
+int empilhamento_degraus(problema, int**, int*);
+
+#endif // DEGRAUS_H_INCLUDED
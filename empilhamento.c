@@ -0,0 +1,371 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "empilhamento.h"
+#include "periodico.h"
+#include "paralelo.h"
+#include "reducao.h"
+#include "anytime.h"
+#include "aproximado.h"
+#include "memoria.h"
+#include "kmelhores.h"
+#include "pequeno.h"
+#include "janela.h"
+#include "valores.h"
+#include "degraus.h"
+
+/* Interface de biblioteca para o problema de empilhamento de caixas, permitindo que o
+ * solucionador seja utilizado dentro de outro processo, sem arquivos intermediários.
+ *
+ * Nenhuma das funções desta interface utiliza variáveis globais ou estáticas: todo o estado
+ * de uma resolução fica no problema e na solução passados como parâmetros. Assim, problemas
+ * distintos podem ser resolvidos simultaneamente, em threads distintas. Um mesmo problema,
+ * entretanto, não deve ser resolvido por duas threads ao mesmo tempo, já que os contadores
+ * de esforço computacional são gravados nele.
+ */
+
+/* Cria uma instância do TAD problema a partir de vetores em memória. Os parâmetros de entrada são:
+ *
+ *      - o número n de caixas;
+ *      - a altura máxima h da pilha;
+ *      - os vetores (de tamanho n) com a largura, a altura e a profundidade de cada caixa;
+ *      - o vetor (de tamanho n) com os valores associados às caixas.
+ *
+ * Assim como no processamento do arquivo de entrada, cada caixa dá origem a duas rotações:
+ * a caixa i corresponde aos índices 2*i (rotação 1) e 2*i + 1 (rotação 2, com a largura e a
+ * altura trocadas) do problema criado.
+ *
+ * Retorna uma instância do TAD problema ou NULL, caso algum vetor seja NULL ou haja problemas
+ * na alocação dinâmica de memória.
+ *
+ * Complexidade: O(n)
+ */
+problema cria_problema_de_vetores(int n, int h, const int* l, const int* a, const int* p, const int* v)
+{
+    problema prob; // Instância do tipo problema que será retornada.
+    caixa c; // Variável auxiliar.
+    int i; // Variável auxiliar.
+
+    if (!l || !a || !p || !v) // Verifica se os vetores foram informados.
+        return NULL;
+
+    prob = cria_problema((2*n), h);
+
+    if (prob) { // Verifica se a alocação de memória foi realizada com sucesso.
+        for(i = 0; i < n; i++) {
+            add_valor(prob, v[i]); // Adiciona o valor associado à caixa com a rotação 1.
+            add_valor(prob, v[i]); // Adiciona o valor associado à caixa com a rotação 2.
+
+            c.l = l[i];
+            c.a = a[i];
+            c.p = p[i];
+            add_caixa(prob, c); // Adiciona a caixa ao problema.
+
+            c.l = a[i]; // Rotaciona a caixa, trocando a
+            c.a = l[i]; // largura com a altura.
+            add_caixa(prob, c); // Adiciona a caixa (com rotação 2) ao problema.
+        }
+    }
+
+    return prob; // Retorna uma instância do TAD problema ou NULL.
+} // fim da função cria_problema_de_vetores
+
+
+/* Preenche uma estrutura de opções com os valores padrão: resolução pela estratégia
+ * iterativa (bottom-up), com redução da instância, uma thread por processador na estratégia
+ * paralela, arquivo de índices temporário e nenhum ponto de verificação na estratégia em
+ * memória externa, nenhum prazo na estratégia anytime, o erro padrão na estratégia aproximada
+ * e a variante da estratégia iterativa especializada para a instância.
+ *
+ * Complexidade: O(1)
+ */
+void inicializa_opcoes(opcoes_empilhamento* opcoes)
+{
+    opcoes->motor = MOTOR_BOTTOM_UP;
+    opcoes->threads = 0;
+    opcoes->reduzir = 1;
+    inicializa_configuracao_externo(&opcoes->externo);
+    opcoes->prazo = 0;
+    opcoes->epsilon = 0;
+    opcoes->contadores = 0;
+    opcoes->especializar = 1;
+} // fim da função inicializa_opcoes
+
+
+/* Retorna o nome da estratégia de resolução (uma das constantes MOTOR_*), usado nas mensagens
+ * dos programas, ou "?" para uma estratégia desconhecida.
+ *
+ * Complexidade: O(1)
+ */
+const char* nome_motor(int motor)
+{
+    switch (motor) {
+    case MOTOR_BOTTOM_UP:
+        return "bottom-up";
+    case MOTOR_TOP_DOWN:
+        return "top-down";
+    case MOTOR_BRANCH_AND_BOUND:
+        return "branch-and-bound";
+    case MOTOR_PERIODICO:
+        return "periodico";
+    case MOTOR_PARALELO:
+        return "paralelo";
+    case MOTOR_EXTERNO:
+        return "externo";
+    case MOTOR_ANYTIME:
+        return "anytime";
+    case MOTOR_APROXIMADO:
+        return "aproximado";
+    case MOTOR_JANELA:
+        return "janela";
+    case MOTOR_VALOR:
+        return "valor";
+    case MOTOR_DEGRAUS:
+        return "degraus";
+    }
+    return "?";
+} // fim da função nome_motor
+
+
+/* Resolve o problema de empilhamento com a estratégia escolhida nas opções (ou a estratégia
+ * padrão, caso opcoes seja NULL). A solução é gravada na estrutura passada por referência,
+ * que deve ser liberada posteriormente com a função termina_solucao.
+ *
+ * Com a redução habilitada, a estratégia resolve uma cópia reduzida do problema (função
+ * reduz_problema) e os índices da pilha obtida são convertidos para os do problema original,
+ * que não é alterado.
+ *
+ * Se pedido nas opções (campo contadores), são contadas durante a resolução, quando o sistema
+ * permite, as falhas de TLB e a fração de acessos à memória de outro nó NUMA, gravadas nas
+ * estatísticas da solução. Sem o pedido, nenhum contador de hardware é aberto.
+ *
+ * Se o problema tiver um controle de resolução (campo controle), ele é repassado à estratégia, que
+ * informa o progresso e atende aos pedidos de cancelamento (ver acompanha_resolucao). Na estratégia
+ * paralela, o progresso é informado pela thread que chamou esta função, e o pedido interrompe todas
+ * as threads.
+ *
+ * Retorna o valor da solução ótima, -1 em caso de falha na alocação de memória ou de estratégia
+ * desconhecida, ou RESOLUCAO_CANCELADA, se a resolução for cancelada.
+ *
+ * Complexidade: a da estratégia escolhida.
+ */
+int resolve_empilhamento(problema p, const opcoes_empilhamento* opcoes, solucao_empilhamento* s)
+{
+    opcoes_empilhamento padrao; // Opções usadas quando nenhuma é informada.
+    problema q = p; // Problema efetivamente resolvido (o original ou o reduzido).
+    int *id_original = NULL, i; // Índices originais das caixas do problema reduzido.
+    contadores_memoria contadores; // Contadores de hardware de acesso à memória.
+
+    s->valor = -1;     // Inicializa a solução, que
+    s->limitante = -1;
+    s->caixas = NULL;  // só será preenchida em caso
+    s->tam = 0;        // de sucesso.
+    s->est.subproblemas = 0;
+    s->est.transicoes = 0;
+    s->est.segundos_grafo = 0;
+    s->est.caixas_eliminadas = 0;
+    s->est.tipo_paginas = PAGINAS_COMUNS;
+    s->est.falhas_tlb = -1;
+    s->est.fracao_remota = -1;
+
+    if (!p) // Verifica se o problema é válido.
+        return -1;
+
+    if (!opcoes) {
+        inicializa_opcoes(&padrao);
+        opcoes = &padrao;
+    }
+
+    if (opcoes->motor < 0 || opcoes->motor >= NUM_MOTORES)
+        return -1; // Estratégia desconhecida.
+
+    // Cancelamento pedido antes do início da resolução.
+    if (p->controle && atomic_load_explicit(&p->controle->cancelar, memory_order_relaxed))
+        return s->valor = s->limitante = RESOLUCAO_CANCELADA;
+
+    p->est.caixas_eliminadas = 0;
+
+    if (opcoes->reduzir) {
+        q = reduz_problema(p, &id_original);
+        if (!q) // Verifica se a redução foi bem sucedida.
+            return -1; // Falha, devido à ausência de recursos computacionais.
+        q->controle = p->controle; // O problema reduzido é resolvido sob o mesmo controle
+        q->perfil = p->perfil;     // e com a mesma medição por fase.
+    }
+
+    q->est.tipo_paginas = PAGINAS_COMUNS; // Atualizado pelas estratégias que alocam tabelas.
+    q->est.falhas_tlb = -1;
+    q->est.fracao_remota = -1;
+    if (opcoes->contadores)
+        inicia_contadores_memoria(&contadores);
+
+    switch (opcoes->motor) { // Analisa qual será a função usada na solução do problema.
+    case MOTOR_BOTTOM_UP: // Instâncias pequenas usam linhas de bits de tamanho fixo (pequeno.c).
+        if (!opcoes->especializar) // Variante geral, sem especialização.
+            s->valor = empilhamento_bottom_up(q, &s->caixas, &s->tam);
+        else if (limite_valor(q) < q->h) // Há menos valores possíveis do que alturas (valores.c).
+            s->valor = empilhamento_por_valor(q, &s->caixas, &s->tam);
+        else
+            s->valor = empilhamento_bottom_up_pequeno(q, &s->caixas, &s->tam);
+        break;
+    case MOTOR_TOP_DOWN:
+        s->valor = empilhamento_top_down(q, &s->caixas, &s->tam);
+        break;
+    case MOTOR_BRANCH_AND_BOUND:
+        s->valor = empilhamento_branch_and_bound(q, &s->caixas, &s->tam);
+        break;
+    case MOTOR_PERIODICO:
+        s->valor = empilhamento_periodico(q, &s->caixas, &s->tam);
+        break;
+    case MOTOR_PARALELO:
+        s->valor = empilhamento_top_down_paralelo(q, opcoes->threads, &s->caixas, &s->tam);
+        break;
+    case MOTOR_EXTERNO:
+        s->valor = empilhamento_bottom_up_externo(q, &opcoes->externo, &s->caixas, &s->tam);
+        break;
+    case MOTOR_ANYTIME:
+        s->valor = empilhamento_anytime(q, opcoes->prazo, &s->caixas, &s->tam, &s->limitante);
+        break;
+    case MOTOR_APROXIMADO:
+        s->valor = empilhamento_aproximado(q, opcoes->epsilon, &s->caixas, &s->tam, &s->limitante);
+        break;
+    case MOTOR_JANELA:
+        s->valor = empilhamento_janela(q, &s->caixas, &s->tam);
+        break;
+    case MOTOR_VALOR:
+        s->valor = empilhamento_por_valor(q, &s->caixas, &s->tam);
+        break;
+    case MOTOR_DEGRAUS:
+        s->valor = empilhamento_degraus(q, &s->caixas, &s->tam);
+        break;
+    }
+
+    if (opcoes->contadores)
+        encerra_contadores_memoria(&contadores, &q->est);
+    s->est = p->est = q->est; // Copia os contadores da resolução.
+
+    // As estratégias anytime e aproximada calculam o seu próprio limitante; as demais são exatas.
+    if ((opcoes->motor != MOTOR_ANYTIME && opcoes->motor != MOTOR_APROXIMADO) || s->valor < 0)
+        s->limitante = s->valor;
+
+    if (q != p) { // Converte a pilha para os índices do problema original.
+        for(i = 0; i < s->tam; i++)
+            s->caixas[i] = id_original[s->caixas[i]];
+
+        s->est.caixas_eliminadas = p->est.caixas_eliminadas = p->n - q->n;
+
+        termina_problema(q);
+        free(id_original);
+    }
+
+    return s->valor; // Retorna a solução ótima, -1 ou RESOLUCAO_CANCELADA.
+} // fim da função resolve_empilhamento
+
+
+/* Resolve o problema de empilhamento retornando as K melhores pilhas distintas (estratégia de
+ * kmelhores.c), em ordem decrescente de valor, no vetor de K soluções passado por referência.
+ * Cada solução preenchida deve ser liberada posteriormente com a função termina_solucao; as
+ * posições excedentes recebem o valor -1 e nenhuma pilha. O limitante de todas as soluções é o
+ * valor ótimo (o da primeira).
+ *
+ * A instância não é reduzida: a redução elimina rotações dominadas, que não fazem parte da pilha
+ * ótima mas podem fazer parte das alternativas.
+ *
+ * Retorna o número de pilhas encontradas (apenas pilhas de valor positivo são consideradas) ou -1,
+ * em caso de falha na alocação de memória.
+ *
+ * Complexidade: a da função empilhamento_k_melhores.
+ */
+int resolve_k_melhores(problema p, int K, solucao_empilhamento* solucoes)
+{
+    int **pilhas, *tamanhos, *valores, encontradas = -1, t; // Resultados da estratégia.
+
+    for(t = 0; t < K; t++) { // Inicializa as soluções, que só serão preenchidas em caso de sucesso.
+        solucoes[t].valor = solucoes[t].limitante = -1;
+        solucoes[t].caixas = NULL;
+        solucoes[t].tam = 0;
+    }
+
+    if (!p || K <= 0)
+        return -1;
+
+    pilhas = (int**) malloc(sizeof(int*) * K);
+    tamanhos = (int*) malloc(sizeof(int) * K);
+    valores = (int*) malloc(sizeof(int) * K);
+
+    if (pilhas && tamanhos && valores) {
+        p->est.tipo_paginas = PAGINAS_COMUNS;
+        p->est.caixas_eliminadas = 0;
+        p->est.falhas_tlb = -1; // Sem contadores de hardware.
+        p->est.fracao_remota = -1;
+        encontradas = empilhamento_k_melhores(p, K, pilhas, tamanhos, valores);
+
+        for(t = 0; t < K; t++) {
+            solucoes[t].est = p->est;
+            if (t < encontradas) {
+                solucoes[t].valor = valores[t];
+                solucoes[t].limitante = valores[0];
+                solucoes[t].caixas = pilhas[t];
+                solucoes[t].tam = tamanhos[t];
+            }
+        }
+    }
+
+    free(pilhas);
+    free(tamanhos);
+    free(valores);
+
+    return encontradas; // Retorna o número de pilhas encontradas ou -1.
+} // fim da função resolve_k_melhores
+
+
+/* Libera o vetor de caixas de uma solução. A estrutura em si pertence ao utilizador e
+ * pode ser reutilizada em uma nova resolução.
+ *
+ * Complexidade: O(1)
+ */
+void termina_solucao(solucao_empilhamento* s)
+{
+    if (s) {
+        free(s->caixas); // Desaloca o vetor com a pilha de caixas.
+        s->caixas = NULL;
+        s->tam = 0;
+    }
+} // fim da função termina_solucao
+
+
+/* Verifica se uma pilha de caixas é uma solução viável para o problema e se o seu valor
+ * corresponde ao informado. Os parâmetros de entrada são o problema, o vetor com os índices
+ * das caixas (da base para o topo), o tamanho do vetor e o valor informado para a pilha.
+ *
+ * Uma pilha é viável se todos os índices são válidos, se cada caixa é empilhável sobre a
+ * caixa imediatamente abaixo (largura e profundidade menores ou iguais) e se a soma das
+ * alturas não excede a altura máxima h.
+ *
+ * Retorna 1 (um) se a pilha é viável e a soma dos valores das caixas é igual ao valor
+ * informado, ou 0 (zero), caso contrário.
+ *
+ * Complexidade: O(tam)
+ */
+int verifica_pilha(problema p, const int* caixas, int tam, int valor)
+{
+    int i; // Variável auxiliar.
+    long long altura = 0, soma = 0; // Altura e valor acumulados da pilha.
+
+    if (!p || tam < 0 || (tam > 0 && !caixas))
+        return 0;
+
+    for(i = 0; i < tam; i++) {
+        if (caixas[i] < 0 || caixas[i] >= p->n) // Índice inválido.
+            return 0;
+
+        // A caixa i deve ser empilhável sobre a caixa i - 1.
+        if (i > 0 && (p->caixas[caixas[i]].l > p->caixas[caixas[i - 1]].l ||
+                      p->caixas[caixas[i]].p > p->caixas[caixas[i - 1]].p))
+            return 0;
+
+        altura += p->caixas[caixas[i]].a;
+        soma += p->v[caixas[i]];
+    }
+
+    return (altura <= p->h && soma == valor);
+} // fim da função verifica_pilha
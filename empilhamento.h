@@ -0,0 +1,74 @@
+#ifndef EMPILHAMENTO_H_INCLUDED
+#define EMPILHAMENTO_H_INCLUDED
+
+#include "estruturas.h"
+#include "externo.h"
+
+/* Estratégias de resolução disponíveis: */
+#define MOTOR_BOTTOM_UP 0 // Programação dinâmica iterativa.
+#define MOTOR_TOP_DOWN 1 // Programação dinâmica recursiva.
+#define MOTOR_BRANCH_AND_BOUND 2 // Programação dinâmica recursiva com poda.
+#define MOTOR_PERIODICO 3 // Programação dinâmica iterativa com detecção de período.
+#define MOTOR_PARALELO 4 // Programação dinâmica recursiva com várias threads.
+#define MOTOR_EXTERNO 5 // Programação dinâmica iterativa em memória externa.
+#define MOTOR_ANYTIME 6 // Torre gulosa melhorada pela programação dinâmica até um prazo.
+#define MOTOR_APROXIMADO 7 // Programação dinâmica com as alturas em escala reduzida.
+#define MOTOR_JANELA 8 // Programação dinâmica iterativa com janela de valores e predecessores compactos.
+#define MOTOR_VALOR 9 // Programação dinâmica iterativa indexada pelo valor acumulado.
+#define MOTOR_DEGRAUS 10 // Programação dinâmica com os valores de cada caixa representados por degraus.
+#define NUM_MOTORES 11 // Número de estratégias disponíveis.
+
+/* Conversão do índice de uma caixa do problema (cada caixa original gera duas
+ * rotações) para o número da caixa original (a partir de 0) e para a rotação (1 ou 2): */
+#define CAIXA_ORIGINAL(indice) ((indice) / 2)
+#define ROTACAO_CAIXA(indice) ((indice) % 2 + 1)
+
+typedef struct {
+    /* Estratégia de resolução (uma das constantes MOTOR_*): */
+    int motor;
+    /* Número de threads da estratégia paralela (0 usa todos os processadores): */
+    int threads;
+    /* Se diferente de zero, a instância é reduzida antes da resolução (ver reducao.h): */
+    int reduzir;
+    /* Arquivos e pontos de verificação da estratégia em memória externa (ver externo.h): */
+    configuracao_externo externo;
+    /* Prazo da estratégia anytime, em segundos (0 resolve até a otimalidade): */
+    double prazo;
+    /* Erro relativo das alturas na estratégia aproximada (0 usa o padrão, ver aproximado.h): */
+    double epsilon;
+    /* Se diferente de zero, as falhas de TLB e os acessos a outro nó NUMA são contados com os
+     * contadores de hardware (ver memoria.h); caso contrário, nenhum contador é aberto: */
+    int contadores;
+    /* Se diferente de zero, a estratégia iterativa (MOTOR_BOTTOM_UP) é substituída pela variante
+     * especializada para a instância (linhas de bits ou indexação pelo valor); caso contrário, a
+     * função geral empilhamento_bottom_up é sempre usada, o que serve de referência nos testes: */
+    int especializar;
+} opcoes_empilhamento;
+
+typedef struct {
+    /* Valor da solução ótima (-1 em caso de falha, RESOLUCAO_CANCELADA se cancelada): */
+    int valor;
+    /* Limitante superior para o valor ótimo (igual ao valor, se a solução é ótima): */
+    int limitante;
+    /* Pilha de caixas, da base para o topo, e o seu tamanho: */
+    int* caixas;
+    int tam;
+    /* Contadores de esforço computacional da resolução: */
+    estatisticas_empilhamento est;
+} solucao_empilhamento;
+
+problema cria_problema_de_vetores(int, int, const int*, const int*, const int*, const int*);
+
+void inicializa_opcoes(opcoes_empilhamento*);
+
+const char* nome_motor(int);
+
+int resolve_empilhamento(problema, const opcoes_empilhamento*, solucao_empilhamento*);
+
+int resolve_k_melhores(problema, int, solucao_empilhamento*);
+
+void termina_solucao(solucao_empilhamento*);
+
+int verifica_pilha(problema, const int*, int, int);
+
+#endif // EMPILHAMENTO_H_INCLUDED
@@ -1,17 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 #include "estruturas.h"
-
-/** ASSINATURAS DE FUNÇÕES INTERNAS, CUJAS IMPLEMENTAÇÕES SE ENCONTRAM NO
-  * FINAL DO ARQUIVO.
-  */
-int* cria_vetor_caixas_empilhadas(int**, caixa*, int, int, int*);
-
-lista* cria_vetor_lista_de_caixas_empilhaveis(caixa*, int);
-
-void termina_vetor_lista_de_caixas_empilhaveis(lista*, int);
-
-int max(int*, int, int*);
+#include "grafo.h"
+#include "memoria.h"
+#include "perfil.h"
 
 /* Esta função aloca espaço em memória para uma instância do TAD problema.
  * Os parâmetros de entrada são n (o tamanho do problema, ou seja, o número
@@ -38,13 +31,29 @@ problema cria_problema(int n, int h)
             p->h = h; // Tamanho máximo da pilha.
             p->i_caixas = 0; // Estas variáveis controlam quantas caixas e quantos
             p->i_v = 0;      // valores foram efetivamente adicionados ao problema.
-
-            // Aloca espaço em memória para o array de caixas.
+            p->est.subproblemas = 0; // Zera os contadores
+            p->est.transicoes = 0;   // de esforço computacional.
+            p->est.segundos_grafo = 0;
+            p->est.caixas_eliminadas = 0;
+            p->est.tipo_paginas = 0;
+            p->est.falhas_tlb = -1;
+            p->est.fracao_remota = -1;
+            p->controle = NULL; // Sem controle de cancelamento e de progresso.
+            p->perfil = NULL; // Sem medição por fase.
+
+            // Aloca espaço em memória para o array de caixas e para os vetores de dimensões.
             p->caixas = (caixa*) malloc(sizeof(caixa) * n);
-
-            // Verifica se a alocação foi bem sucedida.
-            if (!p->caixas) {
-                free(p); // Libera a memória alocada.
+            p->l = (int*) malloc(sizeof(int) * n);
+            p->a = (int*) malloc(sizeof(int) * n);
+            p->p = (int*) malloc(sizeof(int) * n);
+
+            // Verifica se as alocações foram bem sucedidas.
+            if (!p->caixas || !p->l || !p->a || !p->p) {
+                free(p->caixas); // Libera a
+                free(p->l);      // memória
+                free(p->a);      // alocada.
+                free(p->p);
+                free(p);
                 return NULL; // Retorna NULL, devido a não ter conseguido alocar memória.
 
             } else {
@@ -55,6 +64,9 @@ problema cria_problema(int n, int h)
                 if (!p->v) {
 
                     free(p->caixas); // Libera a memória do array de caixas.
+                    free(p->l); // Libera a memória
+                    free(p->a); // dos vetores de
+                    free(p->p); // dimensões.
                     free(p); // Libera a memória do problema.
                     p = NULL; // O problema recebe NULL.
 
@@ -79,6 +91,9 @@ void termina_problema(problema p)
     if (p) {
         free(p->caixas); // Desaloca o vetor caixas.
         free(p->v); // Desaloca o vetor v.
+        free(p->l); // Desaloca os
+        free(p->a); // vetores de
+        free(p->p); // dimensões.
         free(p); // Desaloca o espaço utilizado pela variável do tipo problema.
     }
 } // fim da função termina_problema
@@ -99,6 +114,9 @@ int add_caixa(problema p, caixa c)
     // A variável i_caixas controla quantas caixas de fato foram adicionadas e
     // n é o tamanho (número de caixas) do problema.
     if (p->i_caixas < p->n) {
+        p->l[p->i_caixas] = c.l; // Copia as dimensões para os
+        p->a[p->i_caixas] = c.a; // vetores de dimensões.
+        p->p[p->i_caixas] = c.p;
         p->caixas[p->i_caixas++] = c;   // Adiciona a caixa (c) ao vetor de caixas (p->caixas)
         // e incrementa i_caixas.
         return 1; // Sucesso na inserção.
@@ -131,6 +149,27 @@ int add_valor(problema p, int v)
 } // fim da função add_valor
 
 
+/* Consulta o controle de uma resolução em andamento: informa o progresso à função de
+ * acompanhamento (se houver) e verifica se o cancelamento foi pedido. Os parâmetros são o
+ * problema, a quantidade de trabalho concluída e o total.
+ *
+ * Retorna 1 (um) se a resolução deve ser interrompida ou 0 (zero), caso contrário (inclusive
+ * quando o problema não tem controle).
+ *
+ * Complexidade: O(1), além da função de acompanhamento.
+ */
+int acompanha_resolucao(problema p, long long feito, long long total)
+{
+    if (!p->controle)
+        return 0;
+
+    if (p->controle->progresso)
+        p->controle->progresso(feito, total, p->controle->dados);
+
+    return atomic_load_explicit(&p->controle->cancelar, memory_order_relaxed) != 0;
+} // fim da função acompanha_resolucao
+
+
 /* Encontra a solução ótima para o problema de empilhamento de caixas, utilizando programação
  * dinâmica e uma estratégia de resolução iterativa (bottom up). O parâmetro de entrada p
  * contém todas as informações necessárias à resolução do problema: a altura máxima da pilha
@@ -140,7 +179,8 @@ int add_valor(problema p, int v)
  * Retorna o valor da solução ótima encontrada, além de retornar um vetor (e seu tamanho) com
  * os índices das caixas utilizadas no empilhamento de altura máxima h. Em caso de falha na
  * alocação de recursos computacionais, a função retorna o valor -1, NULL no lugar do vetor
- * com os índices das caixas e o tamanho 0 (zero).
+ * com os índices das caixas e o tamanho 0 (zero). Se o cancelamento for pedido pelo controle
+ * do problema (ver acompanha_resolucao), retorna RESOLUCAO_CANCELADA, também sem pilha.
  *
  * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
  * desta função desalocá-lo posteriormente.
@@ -153,7 +193,7 @@ int empilhamento_bottom_up(problema p, int** vetor_de_caixas_empilhadas, int* ta
     // da sequência de caixas utilizadas no empilhamento.
     int **matriz_emp, **matriz_indices;
 
-    int k, i, j, h_aux, solucao_otima, pos; // Variáveis auxiliares.
+    int k, i, j, h_aux, solucao_otima, linha, pos; // Variáveis auxiliares.
 
     // Vetor, de listas encadeadas simples, utilizado para armazenar, para cada caixa, uma
     // relação das demais caixas que são empilháveis sobre ela (empilhamento estável).
@@ -168,12 +208,15 @@ int empilhamento_bottom_up(problema p, int** vetor_de_caixas_empilhadas, int* ta
     *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
     *tam = 0;                           // referência e que retornarão valores também.
 
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
     matriz_emp = (int**) malloc(sizeof(int*) * (p->h + 1)); // Aloca as linhas da matriz.
     if (!matriz_emp) // Verifica se a alocação foi bem sucedida.
         return -1; // Falha no cálculo da solução ótima, devido à ausência de recursos computacionais.
 
     // Aloca o restante da matriz, sem fragmentação.
-    matriz_emp[0] = (int*) malloc(sizeof(int) * (p->h + 1) * (p->n));
+    matriz_emp[0] = (int*) aloca_tabela(sizeof(int) * (p->h + 1) * p->n, &p->est.tipo_paginas);
     if (!matriz_emp[0]) { // Verifica se a alocação foi bem sucedida.
         free(matriz_emp);       // Libera os recursos alocados anteriormente.
         return -1; // Falha no cálculo da solução ótima, devido à ausência de recursos computacionais.
@@ -181,31 +224,32 @@ int empilhamento_bottom_up(problema p, int** vetor_de_caixas_empilhadas, int* ta
 
     matriz_indices = (int**) malloc(sizeof(int*) * (p->h + 1)); // Aloca as linhas da matriz.
     if (!matriz_indices) { // Verifica se a alocação foi bem sucedida.
-        free(matriz_emp[0]);    // Libera os recursos
-        free(matriz_emp);       // alocados anteriormente.
+        libera_tabela(matriz_emp[0]); // Libera os recursos
+        free(matriz_emp);             // alocados anteriormente.
         return -1; // Falha no cálculo da solução ótima, devido à ausência de recursos computacionais.
     }
 
     // Aloca o restante da matriz, sem fragmentação.
-    matriz_indices[0] = (int*) malloc(sizeof(int) * (p->h + 1) * p->n);
+    matriz_indices[0] = (int*) aloca_tabela(sizeof(int) * (p->h + 1) * p->n, &p->est.tipo_paginas);
     if (!matriz_indices[0]) { // Verifica se a alocação foi bem sucedida.
-        free(matriz_emp[0]);    // Libera os recursos
-        free(matriz_emp);       // alocados
-        free(matriz_indices);   // anteriormente.
+        libera_tabela(matriz_emp[0]); // Libera os recursos
+        free(matriz_emp);             // alocados
+        free(matriz_indices);         // anteriormente.
         return -1; // Falha no cálculo da solução ótima, devido à ausência de recursos computacionais.
     }
 
     // Cria o vetor com as listas de caixas empilháveis.
-    vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p->caixas, p->n);
+    vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p);
     if (!vetor_lista_de_caixas_empilhaveis) { // Verifica se a alocação foi bem sucedida.
-        free(matriz_emp[0]);     // Libera os
-        free(matriz_emp);        // recursos
-        free(matriz_indices[0]); // alocados
-        free(matriz_indices);    // anteriormente.
+        libera_tabela(matriz_emp[0]);     // Libera os
+        free(matriz_emp);                 // recursos
+        libera_tabela(matriz_indices[0]); // alocados
+        free(matriz_indices);             // anteriormente.
         return -1; // Falha no cálculo da solução ótima, devido à ausência de recursos computacionais.
     }
 
     // Inicialização de valores.
+    inicia_fase(p, FASE_PROGRAMACAO);
     for(i = 0; i < p->n; i++) {
         matriz_emp[0][i] = 0; // Inicializa a primeira linha da matriz com 0 (zero).
         matriz_indices[0][i] = -1;  // Inicializa a primeira linha da matriz que guarda
@@ -228,6 +272,9 @@ int empilhamento_bottom_up(problema p, int** vetor_de_caixas_empilhadas, int* ta
 
             if (h_aux >= 0) { // Se o valor anterior for não-negativo, a caixa cabe na pilha.
 
+                p->est.subproblemas++; // Contabiliza o subproblema (k, l, p) avaliado.
+                p->est.transicoes += vetor_lista_de_caixas_empilhaveis[i]->tamanho;
+
                 // A seguir, percorre-se a lista de caixas que são empilháveis a esta caixa
                 // e verifica-se qual o empilhamento, de uma solução de subproblema menor,
                 // mais o valor desta caixa apresenta o maior valor.
@@ -263,28 +310,35 @@ int empilhamento_bottom_up(problema p, int** vetor_de_caixas_empilhadas, int* ta
                 }
             }
         }
+
+        // A cada INTERVALO_CONTROLE linhas, informa o progresso e verifica se houve pedido de cancelamento.
+        if ((k % INTERVALO_CONTROLE == 0 || k == p->h) && acompanha_resolucao(p, k, p->h))
+            break;
     }
 
     // Libera a memória alocada para o vetor com as listas de caixas empilháveis.
     termina_vetor_lista_de_caixas_empilhaveis(vetor_lista_de_caixas_empilhaveis, p->n);
 
     // A solução ótima, para uma altura máxima h, é dada pelo valor máximo de todas
-    // as soluções (h, l, p), onde h é a última linha da matriz.
-    solucao_otima = max(matriz_emp[p->h], p->n, &pos);
+    // as soluções (k, l, p), com k menor ou igual a h. Se a resolução foi interrompida, não há solução.
+    solucao_otima = (k <= p->h) ? RESOLUCAO_CANCELADA : seleciona_base(matriz_emp, p->n, p->h, &linha, &pos);
+    encerra_fase(p, FASE_PROGRAMACAO);
 
-    free(matriz_emp[0]);    // Libera a memória alocada para a matriz
-    free(matriz_emp);       // de soluções ótimas.
+    libera_tabela(matriz_emp[0]); // Libera a memória alocada para a matriz
+    free(matriz_emp);             // de soluções ótimas.
 
     if (solucao_otima > 0) { // Se a variável é maior do que 0 (zero), uma solução ótima foi encontrada.
         // Gera um vetor com os índices das caixas utilizadas no empilhamento de altura máxima h.
-        (*vetor_de_caixas_empilhadas) = cria_vetor_caixas_empilhadas(matriz_indices, p->caixas, p->h, pos, tam);
+        inicia_fase(p, FASE_RECONSTRUCAO);
+        (*vetor_de_caixas_empilhadas) = reconstroi_pilha(matriz_indices, p->caixas, p->n, linha, pos, tam);
+        encerra_fase(p, FASE_RECONSTRUCAO);
 
         if (!(*vetor_de_caixas_empilhadas)) // Verifica se a alocação foi bem sucedida.
             solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
     }
 
-    free(matriz_indices[0]);    // Libera a memória alocada para a matriz
-    free(matriz_indices);       // que guarda a sequência de empilhamento.
+    libera_tabela(matriz_indices[0]); // Libera a memória alocada para a matriz
+    free(matriz_indices);             // que guarda a sequência de empilhamento.
 
     return solucao_otima; // Retorna a solução ótima ou -1, em caso de falha na alocação de memória.
 } // fim da função empilhamento_bottom_up
@@ -309,7 +363,10 @@ int empilhamento_bottom_up(problema p, int** vetor_de_caixas_empilhadas, int* ta
  *      - a matriz (h x n) que será utilizada para armazenar os índices das caixas que compõem as sequências
  *           de empilhamentos. Na primeira chamada a esta função recursiva, a matriz deve ter sua primeira
  *           linha inicializada com o valor -1;
- *      - um vetor com as listas de todas as caixas que são empilháveis.
+ *      - um vetor com as listas de todas as caixas que são empilháveis;
+ *      - a estrutura de estatísticas, cujos contadores são incrementados a cada subproblema avaliado;
+ *      - o controle da resolução (pode ser NULL). Após um pedido de cancelamento, nenhum subproblema
+ *           novo é calculado e os valores retornados deixam de ser válidos.
  *
  * Retorna o valor da solução ótima, para uma pilha de altura máxima h, associada a uma largura e profundidade
  * específicas da caixa de índice indice_caixa.
@@ -317,13 +374,16 @@ int empilhamento_bottom_up(problema p, int** vetor_de_caixas_empilhadas, int* ta
  * Complexidade: O(nh)
  */
 int empilhamento_recursiva(int h, int indice_caixa, int n, caixa* caixas, int* valores,
-                           int** matriz_emp, int** matriz_indices, lista* vetor_lista_de_caixas_empilhaveis)
+                           int** matriz_emp, int** matriz_indices, lista* vetor_lista_de_caixas_empilhaveis,
+                           estatisticas_empilhamento* est, controle_resolucao* controle)
 {
     int i, h_aux, emp_aux; // Variáveis auxiliares.
     tipo_nodo *no; // Variável do tipo tipo_nodo utilizada para percorrer a lista de caixas empilháveis.
 
     if (matriz_emp[h][indice_caixa] != -1)  // Se o valor procurado já foi calculado, ou seja, já se
         return matriz_emp[h][indice_caixa]; // encontra na matriz de soluções ótimas, basta retorná-lo.
+    else if (controle && atomic_load_explicit(&controle->cancelar, memory_order_relaxed))
+        return 0; // Resolução cancelada: o subproblema não é calculado.
     else {
 
         matriz_emp[h][indice_caixa] = 0;       // Inicializa a posição da matriz de soluções ótimas com 0 (zero).
@@ -333,6 +393,9 @@ int empilhamento_recursiva(int h, int indice_caixa, int n, caixa* caixas, int* v
 
         if (h_aux >= 0) { // Se o valor anterior for não-negativo, a caixa cabe na pilha.
 
+            est->subproblemas++; // Contabiliza o subproblema (h, l, p) avaliado.
+            est->transicoes += vetor_lista_de_caixas_empilhaveis[indice_caixa]->tamanho;
+
             // A seguir, percorre-se a lista de caixas que são empilháveis à caixa de índice indice_caixa
             // e verifica-se qual o empilhamento, de uma solução de subproblema menor, mais o valor desta
             // caixa apresenta o maior valor.
@@ -349,8 +412,8 @@ int empilhamento_recursiva(int h, int indice_caixa, int n, caixa* caixas, int* v
                 // A chamada recursiva a seguir é responsável por calcular a solução ótima de um subproblema
                 // menor. Ao somar o resultado com o valor da caixa de índice indice_caixa, obtém-se uma solução
                 // de empilhamento, mas que não se sabe ser a ótima.
-                emp_aux = empilhamento_recursiva(h_aux, i, n, caixas,
-                                                 valores, matriz_emp, matriz_indices, vetor_lista_de_caixas_empilhaveis)
+                emp_aux = empilhamento_recursiva(h_aux, i, n, caixas, valores, matriz_emp,
+                                                 matriz_indices, vetor_lista_de_caixas_empilhaveis, est, controle)
                           + valores[indice_caixa];
 
                 // Através da estrutura condicional a seguir, escolhe-se o maior valor dentre todos
@@ -388,7 +451,8 @@ int empilhamento_recursiva(int h, int indice_caixa, int n, caixa* caixas, int* v
  *
  * Retorna o valor da solução ótima encontrada, além de retornar um vetor (e seu tamanho) com
  * os índices das caixas utilizadas no empilhamento de altura máxima h. Em caso de falha na
- * alocação de recursos computacionais, a função retorna o valor -1.
+ * alocação de recursos computacionais, a função retorna o valor -1. Se o cancelamento for
+ * pedido pelo controle do problema, retorna RESOLUCAO_CANCELADA.
  *
  * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
  * desta função desalocá-lo posteriormente.
@@ -400,7 +464,7 @@ int empilhamento_top_down(problema p, int** vetor_de_caixas_empilhadas, int* tam
     // As matrizes a seguir são utilizadas para o cálculo da solução ótima e para o cálculo
     // da sequência de caixas utilizadas no empilhamento.
     int **matriz_emp, **matriz_indices;
-    int i, j, solucao_otima, pos;
+    int i, j, solucao_otima, linha, pos; // Variáveis auxiliares.
 
     // Vetor, de listas encadeadas simples, utilizado para armazenar, para cada caixa, uma
     // relação das demais caixas que são empilháveis sobre ela (empilhamento estável).
@@ -413,12 +477,15 @@ int empilhamento_top_down(problema p, int** vetor_de_caixas_empilhadas, int* tam
     *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
     *tam = 0;                           // referência e que retornarão valores também.
 
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
     matriz_emp = (int**) malloc(sizeof(int*) * (p->h + 1)); // Aloca as linhas da matriz.
     if (!matriz_emp) // Verifica se a alocação foi bem sucedida.
         return -1; // Falha no cálculo da solução ótima, devido à ausência de recursos computacionais.
 
     // Aloca o restante da matriz, sem fragmentação.
-    matriz_emp[0] = (int*) malloc(sizeof(int) * (p->h + 1) * (p->n));
+    matriz_emp[0] = (int*) aloca_tabela(sizeof(int) * (p->h + 1) * p->n, &p->est.tipo_paginas);
     if (!matriz_emp[0]) { // Verifica se a alocação foi bem sucedida.
         free(matriz_emp); // Libera os recursos alocados anteriormente.
         return -1; // Falha no cálculo da solução ótima, devido à ausência de recursos computacionais.
@@ -431,21 +498,21 @@ int empilhamento_top_down(problema p, int** vetor_de_caixas_empilhadas, int* tam
     }
 
     // Aloca o restante da matriz, sem fragmentação.
-    matriz_indices[0] = (int*) malloc(sizeof(int) * (p->h + 1) * p->n);
+    matriz_indices[0] = (int*) aloca_tabela(sizeof(int) * (p->h + 1) * p->n, &p->est.tipo_paginas);
     if (!matriz_indices[0]) { // Verifica se a alocação foi bem sucedida.
-        free(matriz_emp[0]);    // Libera os recursos
-        free(matriz_emp);       // alocados
-        free(matriz_indices);   // anteriormente.
+        libera_tabela(matriz_emp[0]); // Libera os recursos
+        free(matriz_emp);             // alocados
+        free(matriz_indices);         // anteriormente.
         return -1; // Falha no cálculo da solução ótima, devido à ausência de recursos computacionais.
     }
 
     // Cria o vetor com as listas de caixas empilháveis.
-    vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p->caixas, p->n);
+    vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p);
     if (!vetor_lista_de_caixas_empilhaveis) { // Verifica se a alocação foi bem sucedida.
-        free(matriz_emp[0]);     // Libera os
-        free(matriz_emp);        // recursos
-        free(matriz_indices[0]); // alocados
-        free(matriz_indices);    // anteriormente.
+        libera_tabela(matriz_emp[0]);     // Libera os
+        free(matriz_emp);                 // recursos
+        libera_tabela(matriz_indices[0]); // alocados
+        free(matriz_indices);             // anteriormente.
         return -1; // Falha no cálculo da solução ótima, devido à ausência de recursos computacionais.
     }
 
@@ -478,121 +545,584 @@ int empilhamento_top_down(problema p, int** vetor_de_caixas_empilhadas, int* tam
     for(i = 0; i < p->n; i++) {
         // A função empilhamento_recursiva calcula a solução ótima para uma pilha de altura máxima
         // h e uma largura e profundidade (l e p) que estão associadas a uma caixa de índice i.
-        empilhamento_recursiva(p->h, i, p->n, p->caixas, p->v, matriz_emp, matriz_indices, vetor_lista_de_caixas_empilhaveis);
+        empilhamento_recursiva(p->h, i, p->n, p->caixas, p->v, matriz_emp, matriz_indices,
+                               vetor_lista_de_caixas_empilhaveis, &p->est, p->controle);
+
+        // Informa o progresso (caixas da base concluídas) e verifica se houve pedido de cancelamento.
+        if (acompanha_resolucao(p, i + 1, p->n))
+            break;
     }
 
     // A liberação do vetor de listas é realizada através da função específica a seguir.
     termina_vetor_lista_de_caixas_empilhaveis(vetor_lista_de_caixas_empilhaveis, p->n);
 
-    // A solução ótima será o máximo de todos os valores armazenados na linha de índice h
-    // da matriz de soluções ótimas.
-    solucao_otima = max(matriz_emp[p->h], p->n, &pos);
+    // A solução ótima será o máximo de todos os valores já calculados na matriz de
+    // soluções ótimas, da linha 0 (zero) até a linha de índice h. Se a resolução foi
+    // interrompida, não há solução.
+    solucao_otima = (i < p->n) ? RESOLUCAO_CANCELADA : seleciona_base(matriz_emp, p->n, p->h, &linha, &pos);
 
-    free(matriz_emp[0]);    // Libera a memória alocada para a matriz
-    free(matriz_emp);       // de soluções ótimas.
+    libera_tabela(matriz_emp[0]); // Libera a memória alocada para a matriz
+    free(matriz_emp);             // de soluções ótimas.
 
     if (solucao_otima > 0) { // Se a variável é maior do que 0 (zero), uma solução ótima foi encontrada.
         // Gera um vetor com os índices das caixas utilizadas no empilhamento de altura máxima h.
-        (*vetor_de_caixas_empilhadas) = cria_vetor_caixas_empilhadas(matriz_indices, p->caixas, p->h, pos, tam);
+        (*vetor_de_caixas_empilhadas) = reconstroi_pilha(matriz_indices, p->caixas, p->n, linha, pos, tam);
 
         if (!(*vetor_de_caixas_empilhadas)) // Verifica se a alocação foi bem sucedida.
             solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
     }
 
-    free(matriz_indices[0]);    // Libera a memória alocada para a matriz
-    free(matriz_indices);       // que guarda a sequência de empilhamento.
+    libera_tabela(matriz_indices[0]); // Libera a memória alocada para a matriz
+    free(matriz_indices);             // que guarda a sequência de empilhamento.
 
     return solucao_otima; // Retorna a solução ótima ou -1, em caso de falha na alocação de memória.
 } // fim da função empilhamento_top_down
 
-/*********************************************************************************************************
- *                                  INÍCIO DAS FUNÇÕES INTERNAS
- *********************************************************************************************************/
 
-/* Cria, a partir de uma matriz de índices, um vetor com a sequência de caixas utilizadas
- * em um empilhamento. A primeira posição do vetor contém o índice da caixa que é a base da
- * pilha e a última posição contém o índice da caixa que está no topo.
+/* Estrutura auxiliar que reúne os dados compartilhados pelas chamadas da função
+ * empilhamento_recursiva_bb, evitando uma lista extensa de parâmetros.
+ */
+typedef struct {
+    caixa* caixas; // Vetor de caixas.
+    int* valores; // Vetor de valores associados às caixas.
+    int** matriz_emp; // Soluções ótimas (célula exata) ou limitantes superiores (célula podada).
+    int** matriz_indices; // Sequências de empilhamentos das células exatas.
+    char** matriz_estado; // Estado de cada célula (ESTADO_DESCONHECIDO, ESTADO_LIMITANTE ou ESTADO_EXATO).
+    int* inicio; // Os filhos da caixa i ocupam as posições inicio[i] até inicio[i+1]-1 do vetor filhos,
+    int* filhos; // em ordem decrescente da razão valor/altura que podem alcançar.
+    razao_caixa* razao; // Melhor razão valor/altura alcançável a partir de cada caixa.
+    estatisticas_empilhamento* est; // Contadores de esforço computacional.
+    controle_resolucao* controle; // Controle de cancelamento da resolução (pode ser NULL).
+} contexto_bb;
+
+#define ESTADO_DESCONHECIDO 0 // A célula ainda não foi avaliada.
+#define ESTADO_LIMITANTE 1 // A célula guarda apenas um limitante superior para a solução ótima.
+#define ESTADO_EXATO 2 // A célula guarda a solução ótima do subproblema.
+
+/* Calcula um limitante superior otimista para o subproblema (h, indice_caixa): nenhuma pilha
+ * de altura máxima h apoiada na caixa pode valer mais do que a melhor razão valor/altura
+ * alcançável a partir dela multiplicada por h.
+ *
+ * Complexidade: O(1)
+ */
+long long limitante_bb(contexto_bb* ctx, int h, int indice_caixa)
+{
+    return ((long long) ctx->razao[indice_caixa].v * h) / ctx->razao[indice_caixa].a;
+} // fim da função limitante_bb
+
+
+/* Função recursiva, do tipo branch and bound, que calcula a solução ótima do subproblema
+ * (h, l, p) associado à caixa de índice indice_caixa, desde que essa solução seja maior do que
+ * o parâmetro limiar. Os vizinhos são explorados em ordem decrescente de limitante superior e a
+ * exploração é interrompida assim que nenhum vizinho restante puder superar a melhor solução
+ * conhecida (ou o limiar).
+ *
+ * Retorna a solução ótima do subproblema, caso ela seja maior do que limiar. Caso contrário,
+ * retorna um valor menor ou igual a limiar, significando apenas que o subproblema não é capaz
+ * de superá-lo. Somente as células cuja solução ótima foi provada são marcadas como exatas e
+ * têm a sequência de empilhamento registrada em matriz_indices.
+ *
+ * Complexidade: O(n²h), no pior caso.
+ */
+int empilhamento_recursiva_bb(int h, int indice_caixa, int limiar, contexto_bb* ctx)
+{
+    int k, j, h_aux, melhor, indice, corte, emp_aux, valor; // Variáveis auxiliares.
+
+    // Se a solução ótima já foi calculada, basta retorná-la.
+    if (ctx->matriz_estado[h][indice_caixa] == ESTADO_EXATO)
+        return ctx->matriz_emp[h][indice_caixa];
+
+    // Se já se sabe que o subproblema não supera o limiar, não é necessário reavaliá-lo.
+    if (ctx->matriz_estado[h][indice_caixa] == ESTADO_LIMITANTE && ctx->matriz_emp[h][indice_caixa] <= limiar)
+        return ctx->matriz_emp[h][indice_caixa];
+
+    // Após um pedido de cancelamento, nenhum subproblema novo é avaliado.
+    if (ctx->controle && atomic_load_explicit(&ctx->controle->cancelar, memory_order_relaxed))
+        return limiar;
+
+    h_aux = h - ctx->caixas[indice_caixa].a; // Subtrai a altura da caixa da altura h.
+
+    if (h_aux < 0) { // A caixa não cabe na pilha: a solução ótima é 0 (zero).
+        ctx->matriz_emp[h][indice_caixa] = 0;
+        ctx->matriz_indices[h][indice_caixa] = -1;
+        ctx->matriz_estado[h][indice_caixa] = ESTADO_EXATO;
+        return 0;
+    }
+
+    ctx->est->subproblemas++; // Contabiliza o subproblema (h, l, p) avaliado.
+
+    valor = ctx->valores[indice_caixa];
+    melhor = valor; // A caixa sozinha já é uma pilha válida.
+    indice = -1;
+
+    for(k = ctx->inicio[indice_caixa]; k < ctx->inicio[indice_caixa + 1]; k++) {
+        j = ctx->filhos[k];
+
+        // Valor que um empilhamento precisa superar para ser útil.
+        corte = (melhor > limiar) ? melhor : limiar;
+
+        // Como os filhos estão ordenados pelo limitante, se este filho não é capaz de
+        // superar o corte, nenhum dos seguintes será.
+        if (valor + limitante_bb(ctx, h_aux, j) <= corte)
+            break;
+
+        ctx->est->transicoes++; // Contabiliza o empilhamento examinado.
+
+        emp_aux = empilhamento_recursiva_bb(h_aux, j, corte - valor, ctx);
+
+        // Um valor maior do que o limiar passado ao filho é sempre exato.
+        if (emp_aux > corte - valor) {
+            melhor = valor + emp_aux;
+            indice = j;
+        }
+    }
+
+    if (melhor > limiar) { // A solução encontrada é a ótima para o subproblema.
+        ctx->matriz_emp[h][indice_caixa] = melhor;
+        ctx->matriz_indices[h][indice_caixa] = indice;
+        ctx->matriz_estado[h][indice_caixa] = ESTADO_EXATO;
+        return melhor;
+    }
+
+    // Provou-se apenas que o subproblema não supera o limiar, que passa a ser
+    // o limitante superior guardado para a célula.
+    ctx->matriz_emp[h][indice_caixa] = limiar;
+    ctx->matriz_estado[h][indice_caixa] = ESTADO_LIMITANTE;
+    return limiar;
+} // fim da função empilhamento_recursiva_bb
+
+
+/* Calcula, para cada caixa i, a melhor razão valor/altura dentre todas as caixas que podem ser
+ * empilhadas sobre ela (incluindo ela própria). Como a relação de empilhamento é transitiva, essa
+ * é também a melhor razão de qualquer pilha apoiada na caixa i, de modo que nenhuma pilha de altura
+ * máxima h apoiada nela vale mais do que a razão multiplicada por h.
+ *
+ * Os parâmetros de entrada são o vetor de caixas, o vetor de valores, o tamanho n desses vetores
+ * e o vetor (de tamanho n) que receberá as razões.
+ *
+ * Complexidade: O(n²)
+ */
+void calcula_melhores_razoes(caixa* caixas, int* valores, int n, razao_caixa* razao)
+{
+    int i, j; // Variáveis usadas no controle de iterações das estruturas de repetição.
+
+    for(i = 0; i < n; i++) {
+        razao[i].indice = i;
+        razao[i].v = valores[i];
+        razao[i].a = caixas[i].a;
+
+        for(j = 0; j < n; j++)
+            if ((caixas[i].l >= caixas[j].l) && (caixas[i].p >= caixas[j].p) &&
+                    (long long) valores[j] * razao[i].a > (long long) razao[i].v * caixas[j].a) {
+                razao[i].v = valores[j];
+                razao[i].a = caixas[j].a;
+            }
+    }
+} // fim da função calcula_melhores_razoes
+
+
+/* Compara duas razões valor/altura, para ordenação decrescente com a função qsort.
+ * Empates são desfeitos pelo índice da caixa, para que a ordenação seja determinística.
+ */
+int compara_razao_decrescente(const void* x, const void* y)
+{
+    const razao_caixa *r1 = (const razao_caixa*) x, *r2 = (const razao_caixa*) y;
+    long long d = (long long) r2->v * r1->a - (long long) r1->v * r2->a;
+
+    if (d != 0)
+        return (d > 0) ? 1 : -1;
+
+    return r1->indice - r2->indice;
+} // fim da função compara_razao_decrescente
+
+
+/* Dados compartilhados pelos blocos de linhas da construção dos vetores de filhos. */
+typedef struct {
+    problema p; // Problema cujas caixas são comparadas.
+    const int* l_ordem; // Larguras das caixas, em ordem decrescente de razão.
+    const int* p_ordem; // Profundidades das caixas, em ordem decrescente de razão.
+    const razao_caixa* ordem; // Caixas, em ordem decrescente de razão.
+    int* inicio; // Posição inicial dos filhos de cada caixa.
+    int* filhos; // Vetor de filhos (NULL durante a contagem).
+} dados_filhos_bb;
+
+
+/* Conta (se dados->filhos é NULL) ou grava os filhos das caixas de índices inicio a fim - 1, na
+ * ordem decrescente de razão, a partir das linhas de bits da função marca_empilhaveis. Na
+ * contagem, o número de filhos da caixa i é gravado em dados->inicio[i + 1].
+ *
+ * Retorna 1 (um) em caso de sucesso ou 0 (zero), caso haja falha na alocação de memória.
+ *
+ * Complexidade: O(n(fim - inicio))
+ */
+int preenche_filhos_bb(int inicio, int fim, void* dados)
+{
+    dados_filhos_bb* d = (dados_filhos_bb*) dados; // Dados compartilhados.
+    unsigned long long *bits, palavra; // Linha de bits da caixa base e palavra em análise.
+    int i, w, k; // Variáveis auxiliares.
+
+    bits = (unsigned long long*) malloc(sizeof(unsigned long long) * PALAVRAS_LINHA(d->p->n));
+    if (!bits)
+        return 0;
+
+    for(i = inicio; i < fim; i++) {
+        marca_empilhaveis(d->l_ordem, d->p_ordem, d->p->n, d->p->l[i], d->p->p[i], bits);
+
+        if (!d->filhos) { // Contagem.
+            for(w = 0, k = 0; w < PALAVRAS_LINHA(d->p->n); w++)
+                k += __builtin_popcountll(bits[w]);
+            d->inicio[i + 1] = k;
+        } else { // Gravação, já na ordem decrescente de razão.
+            k = d->inicio[i];
+            for(w = 0; w < PALAVRAS_LINHA(d->p->n); w++)
+                for(palavra = bits[w]; palavra; palavra &= palavra - 1)
+                    d->filhos[k++] = d->ordem[w * BITS_POR_PALAVRA + __builtin_ctzll(palavra)].indice;
+        }
+    }
+
+    free(bits);
+    return 1;
+} // fim da função preenche_filhos_bb
+
+
+/* Encontra a solução ótima para o problema de empilhamento de caixas, utilizando uma estratégia
+ * recursiva (top down) com poda do tipo branch and bound. Para cada caixa calcula-se a melhor razão
+ * valor/altura dentre as caixas que podem ser empilhadas sobre ela, o que fornece um limitante superior
+ * otimista (razão vezes altura restante) para cada subproblema. Os vizinhos são explorados em ordem
+ * decrescente desse limitante e os subproblemas incapazes de superar a melhor solução conhecida são
+ * descartados. Ainda assim, o valor retornado é comprovadamente o ótimo.
+ *
+ * Os parâmetros e os valores de retorno são os mesmos da função empilhamento_top_down. Os contadores
+ * p->est permitem comparar o número de subproblemas avaliados com o das demais estratégias.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n²h), no pior caso.
+ */
+int empilhamento_branch_and_bound(problema p, int** vetor_de_caixas_empilhadas, int* tam)
+{
+    contexto_bb ctx; // Dados compartilhados pelas chamadas recursivas.
+    razao_caixa *ordem; // Caixas ordenadas pela melhor razão valor/altura alcançável.
+    dados_filhos_bb filhos; // Dados da construção dos vetores de filhos.
+    int *l_ordem, *p_ordem; // Dimensões das caixas, na ordem de razão.
+    int i, k, solucao_otima = 0, raiz = -1, emp_aux; // Variáveis auxiliares.
+    double inicio_grafo; // Início da construção dos vetores de filhos.
+
+    // Verifica se a variável passada como parâmetro representa memória alocada.
+    if (*vetor_de_caixas_empilhadas)
+        free(*vetor_de_caixas_empilhadas); // Libera a memória alocada.
+
+    *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
+    *tam = 0;                           // referência e que retornarão valores também.
+
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
+    ctx.caixas = p->caixas;
+    ctx.valores = p->v;
+    ctx.est = &p->est;
+    ctx.controle = p->controle;
+
+    // Aloca as matrizes (sem fragmentação), os vetores de filhos e os vetores de razões.
+    ctx.matriz_emp = (int**) malloc(sizeof(int*) * (p->h + 1));
+    ctx.matriz_indices = (int**) malloc(sizeof(int*) * (p->h + 1));
+    ctx.matriz_estado = (char**) malloc(sizeof(char*) * (p->h + 1));
+    ctx.inicio = (int*) malloc(sizeof(int) * (p->n + 1));
+    ctx.filhos = NULL; // Alocado após a contagem dos empilhamentos possíveis.
+    ctx.razao = (razao_caixa*) malloc(sizeof(razao_caixa) * p->n);
+    ordem = (razao_caixa*) malloc(sizeof(razao_caixa) * p->n);
+    l_ordem = (int*) malloc(sizeof(int) * p->n);
+    p_ordem = (int*) malloc(sizeof(int) * p->n);
+
+    if (ctx.matriz_emp)
+        ctx.matriz_emp[0] = (int*) aloca_tabela(sizeof(int) * (p->h + 1) * p->n, &p->est.tipo_paginas);
+    if (ctx.matriz_indices)
+        ctx.matriz_indices[0] = (int*) aloca_tabela(sizeof(int) * (p->h + 1) * p->n, &p->est.tipo_paginas);
+    if (ctx.matriz_estado)
+        ctx.matriz_estado[0] = (char*) calloc((size_t) (p->h + 1) * p->n, sizeof(char));
+
+    // Verifica se todas as alocações foram bem sucedidas.
+    if (!ctx.matriz_emp || !ctx.matriz_emp[0] || !ctx.matriz_indices || !ctx.matriz_indices[0] ||
+            !ctx.matriz_estado || !ctx.matriz_estado[0] || !ctx.inicio || !ctx.razao || !ordem ||
+            !l_ordem || !p_ordem) {
+        solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
+
+    } else {
+
+        for(k = 1; k <= p->h; k++) { // Corrige a referência de ponteiros da alocação
+            ctx.matriz_emp[k] = ctx.matriz_emp[k - 1] + p->n; // dinâmica de matriz sem fragmentação.
+            ctx.matriz_indices[k] = ctx.matriz_indices[k - 1] + p->n;
+            ctx.matriz_estado[k] = ctx.matriz_estado[k - 1] + p->n;
+        }
+
+        // Calcula, para cada caixa i, a melhor razão valor/altura dentre as caixas empilháveis sobre ela.
+        calcula_melhores_razoes(p->caixas, p->v, p->n, ctx.razao);
+        for(i = 0; i < p->n; i++)
+            ordem[i] = ctx.razao[i];
+
+        qsort(ordem, p->n, sizeof(razao_caixa), compara_razao_decrescente);
+
+        // As colunas das linhas de bits seguem a ordem decrescente de razão.
+        for(i = 0; i < p->n; i++) {
+            l_ordem[i] = p->l[ordem[i].indice];
+            p_ordem[i] = p->p[ordem[i].indice];
+        }
+
+        inicio_grafo = instante_atual();
+        filhos.p = p;
+        filhos.l_ordem = l_ordem;
+        filhos.p_ordem = p_ordem;
+        filhos.ordem = ordem;
+        filhos.inicio = ctx.inicio;
+        filhos.filhos = NULL;
+
+        // Conta os empilhamentos possíveis, para alocar o vetor de filhos com o tamanho exato.
+        ctx.inicio[0] = 0;
+        if (!executa_por_linhas(p->n, preenche_filhos_bb, &filhos))
+            solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
+        else {
+            for(i = 0; i < p->n; i++)
+                ctx.inicio[i + 1] += ctx.inicio[i];
+
+            // Monta os vetores de filhos já na ordem decrescente de razão.
+            filhos.filhos = ctx.filhos = (int*) malloc(sizeof(int) * ctx.inicio[p->n]);
+            if (!ctx.filhos || !executa_por_linhas(p->n, preenche_filhos_bb, &filhos))
+                solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
+        }
+
+        p->est.segundos_grafo = instante_atual() - inicio_grafo;
+    }
+
+    if (solucao_otima != -1) {
+
+        // A primeira linha das matrizes representa a altura 0 (zero), cuja solução é conhecida.
+        for(i = 0; i < p->n; i++) {
+            ctx.matriz_emp[0][i] = 0;
+            ctx.matriz_indices[0][i] = -1;
+            ctx.matriz_estado[0][i] = ESTADO_EXATO;
+        }
+
+        // As caixas da base são avaliadas em ordem decrescente de limitante. Quando o limitante
+        // de uma base não supera a solução incumbente, nenhuma das seguintes o fará.
+        for(i = 0; i < p->n; i++) {
+            if (limitante_bb(&ctx, p->h, ordem[i].indice) <= solucao_otima)
+                break;
+
+            emp_aux = empilhamento_recursiva_bb(p->h, ordem[i].indice, solucao_otima, &ctx);
+
+            if (emp_aux > solucao_otima) { // Valores acima do limiar são exatos.
+                solucao_otima = emp_aux;
+                raiz = ordem[i].indice;
+            }
+
+            // Informa o progresso (caixas da base avaliadas) e verifica se houve pedido de cancelamento.
+            if (acompanha_resolucao(p, i + 1, p->n)) {
+                solucao_otima = RESOLUCAO_CANCELADA;
+                break;
+            }
+        }
+
+        if (solucao_otima > 0) { // Se a variável é maior do que 0 (zero), uma solução ótima foi encontrada.
+            // Gera um vetor com os índices das caixas utilizadas no empilhamento de altura máxima h.
+            (*vetor_de_caixas_empilhadas) = reconstroi_pilha(ctx.matriz_indices, p->caixas, p->n, p->h, raiz, tam);
+
+            if (!(*vetor_de_caixas_empilhadas)) // Verifica se a alocação foi bem sucedida.
+                solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
+        }
+    }
+
+    // Libera todos os recursos alocados.
+    if (ctx.matriz_emp)
+        libera_tabela(ctx.matriz_emp[0]);
+    if (ctx.matriz_indices)
+        libera_tabela(ctx.matriz_indices[0]);
+    if (ctx.matriz_estado)
+        free(ctx.matriz_estado[0]);
+    free(ctx.matriz_emp);
+    free(ctx.matriz_indices);
+    free(ctx.matriz_estado);
+    free(ctx.inicio);
+    free(ctx.filhos);
+    free(ctx.razao);
+    free(ordem);
+    free(l_ordem);
+    free(p_ordem);
+
+    return solucao_otima; // Retorna a solução ótima ou -1, em caso de falha na alocação de memória.
+} // fim da função empilhamento_branch_and_bound
+
+
+/* Seleciona, a partir da matriz de soluções ótimas, o subproblema de maior valor dentre todas
+ * as linhas de 0 (zero) até h, pois a melhor pilha não precisa ter exatamente a altura h. Em
+ * caso de empate, prevalece a linha mais alta e, dentro dela, a caixa de menor índice. Células
+ * com valor negativo (ainda não calculadas pela estratégia recursiva) são desconsideradas.
+ *
+ * Os parâmetros de entrada são:
+ *
+ *      - a matriz de soluções ótimas;
+ *      - o número n de caixas (colunas da matriz);
+ *      - a altura h da última linha da matriz;
+ *      - duas variáveis, passadas por referência, que receberão a linha e a coluna (caixa da base)
+ *        do subproblema selecionado.
+ *
+ * Retorna o valor do subproblema selecionado. Se não houver célula com valor positivo, retorna
+ * 0 (zero), com a linha e a coluna iguais a -1.
+ *
+ * Complexidade: O(nh)
+ */
+int seleciona_base(int** matriz_emp, int n, int h, int* linha, int* pos)
+{
+    int k, i, maior = 0; // Variáveis auxiliares.
+
+    *linha = -1; // Nenhum subproblema
+    *pos = -1;   // selecionado ainda.
+
+    // As linhas são percorridas da mais alta para a mais baixa, de modo que apenas
+    // valores estritamente maiores substituam o subproblema já selecionado.
+    for(k = h; k >= 0; k--)
+        for(i = 0; i < n; i++)
+            if (matriz_emp[k][i] > maior) {
+                maior = matriz_emp[k][i];
+                *linha = k;
+                *pos = i;
+            }
+
+    return maior;
+} // fim da função seleciona_base
+
+
+/* Reconstrói a pilha de caixas de um subproblema, percorrendo a matriz de índices a partir da
+ * caixa da base. O vetor retornado é alocado uma única vez, com a capacidade máxima que uma pilha
+ * de altura h pode ter (h dividido pela menor altura de caixa, mais um), e preenchido diretamente
+ * durante o percurso, sem estruturas intermediárias. A primeira posição do vetor contém o índice
+ * da caixa que é a base da pilha e a última posição contém o índice da caixa que está no topo.
  *
  * Os parâmetros de entrada são:
  *
  *      - a matriz que guarda todas as sequências de empilhamentos;
- *      - o vetor de caixas (para obtenção das alturas das caixas);
- *      - a altura h do empilhamento;
- *      - a posição da última caixa empilhada;
- *      - uma variável, passada por referência, para armazenar o tamanho do vetor criado.
+ *      - o vetor de caixas (para obtenção das alturas das caixas) e o seu tamanho n;
+ *      - a altura h do subproblema;
+ *      - o índice da caixa da base do subproblema;
+ *      - uma variável, passada por referência, para armazenar o tamanho da pilha.
+ *
+ * O percurso é interrompido se a altura restante se tornar negativa ou se a capacidade do vetor
+ * for atingida, de modo que uma matriz inconsistente jamais provoque leituras fora dos limites.
  *
- * Retorna um vetor e o seu tamanho. Caso haja falha na alocação de recursos computacionais,
- * a função retorna NULL e o tamanho do vetor como 0 (zero).
+ * Retorna o vetor com a pilha e o seu tamanho. Caso haja falha na alocação de recursos computacionais
+ * ou a caixa da base seja inválida, a função retorna NULL e o tamanho como 0 (zero).
  *
  * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
  * desta função desalocá-lo posteriormente.
  *
- * Complexidade: O(h)
+ * Complexidade: O(n + h)
  */
-int* cria_vetor_caixas_empilhadas(int** matriz_indices, caixa* caixas, int h, int pos_ultima_caixa_empilhada, int* tam)
+int* reconstroi_pilha(int** matriz_indices, caixa* caixas, int n, int h, int base, int* tam)
 {
-    int *vetor = NULL, i, aux; // Vetor que será retornado pela função e variáveis auxiliares.
-    lista l; // Variável auxiliar usada para criar uma lista encadeada.
-    tipo_elemento e; // Variável auxiliar usada para inserção de elementos em lista encadeada.
-    tipo_nodo *no; // Variável auxiliar usada para percorrer os nós de uma lista encadeada.
+    int *vetor, i, menor_altura, capacidade; // Vetor que será retornado pela função e variáveis auxiliares.
 
-    *tam = 0; // O tamanho do vetor que será criado é inicializado com 0 (zero).
+    *tam = 0; // O tamanho da pilha é inicializado com 0 (zero).
 
-    // Cria-se uma lista encadeada simples para armazenar a sequência de caixas empilhadas.
-    // A lista é necessária porque não se sabe o número de caixas utilizadas.
-    l = cria_lista();
+    if (base < 0 || base >= n || h < 0) // Verifica se o subproblema é válido.
+        return NULL;
 
-    if (l) { // Verifica se a lista foi alocada com sucesso.
+    // A menor altura de caixa limita o número de caixas de qualquer pilha de altura h.
+    menor_altura = caixas[0].a;
+    for(i = 1; i < n; i++)
+        if (caixas[i].a < menor_altura)
+            menor_altura = caixas[i].a;
 
-        e.chave = pos_ultima_caixa_empilhada;   // Insere, na lista, o índice da última
-        insere_apos(l, e);                      // caixa empilhada (a base da pilha).
+    capacidade = (menor_altura > 0) ? (h / menor_altura + 1) : (h + 1);
+
+    vetor = (int*) malloc(sizeof(int) * capacidade);
+
+    if (vetor) { // Verifica se a alocação foi bem sucedida.
 
         // O valor -1, na matriz de sequência de empilhamentos, indica que, naquela posição,
         // não houve empilhamento de uma caixa sobre outra(s).
-        while (matriz_indices[h][pos_ultima_caixa_empilhada] != -1) {
-            aux = matriz_indices[h][pos_ultima_caixa_empilhada];
+        while (base != -1 && h >= 0 && *tam < capacidade) {
+            vetor[(*tam)++] = base; // Insere a caixa na pilha.
 
-            // Desconta, da altura h, a altura da caixa que já foi inserida na lista.
-            h = h - caixas[pos_ultima_caixa_empilhada].a;
+            i = matriz_indices[h][base]; // Caixa empilhada sobre a caixa inserida.
+            h = h - caixas[base].a;      // Desconta a altura da caixa inserida.
+            base = i;
+        }
+    }
 
-            // A seguir, pega-se o índice da caixa que está sobre a caixa que acabou de ser inserida na lista.
-            pos_ultima_caixa_empilhada = aux; // Pega o valor da matriz, antes da alteração do valor de h.
+    return vetor; // Retorna o vetor criado ou NULL.
+} // fim da função reconstroi_pilha
 
-            e.chave = pos_ultima_caixa_empilhada;   // Insere, no fim da lista,
-            insere_apos(l, e);                      // esta caixa.
-        }
+/*********************************************************************************************************
+ *                                  INÍCIO DAS FUNÇÕES INTERNAS
+ *********************************************************************************************************/
+
+/* Dados compartilhados pelos blocos de linhas da construção das listas de caixas empilháveis. */
+typedef struct {
+    problema p; // Problema cujas caixas são comparadas.
+    lista* vetor_adj; // Vetor de listas em construção.
+} dados_listas_empilhaveis;
+
+
+/* Cria as listas de caixas empilháveis das caixas base de índices inicio a fim - 1. Cada lista é
+ * preenchida a partir da linha de bits da caixa base (função marca_empilhaveis), em ordem
+ * crescente de índice.
+ *
+ * Retorna 1 (um) em caso de sucesso ou 0 (zero), caso haja falha na alocação de memória.
+ *
+ * Complexidade: O(n(fim - inicio))
+ */
+int preenche_listas_empilhaveis(int inicio, int fim, void* dados)
+{
+    problema p = ((dados_listas_empilhaveis*) dados)->p; // Problema cujas caixas são comparadas.
+    lista* vetor_adj = ((dados_listas_empilhaveis*) dados)->vetor_adj; // Vetor de listas.
+    unsigned long long *bits, palavra; // Linha de bits da caixa base e palavra em análise.
+    tipo_elemento e; // Variável auxiliar usada para inserção de elementos em lista encadeada.
+    int i, w; // Variáveis usadas no controle de iterações das estruturas de repetição.
+
+    bits = (unsigned long long*) malloc(sizeof(unsigned long long) * PALAVRAS_LINHA(p->n));
+    if (!bits)
+        return 0;
 
-        // Aloca, dinamicamente, um vetor do tamanho da lista encadeada.
-        vetor = (int*) malloc(sizeof(int) * tamanho_lista(l));
-        *tam = tamanho_lista(l); // O tamanho do vetor é o tamanho da lista.
-
-        // A seguir, percorrem-se todos os nós da lista e copiam-se os índices das
-        // caixas para o vetor, na mesma ordem em que eles aparecem na lista.
-        no = l->first;
-        i = 0;
-        while(no) {
-            vetor[i++] = no->item.chave; // O índice da caixa é copiado da lista para o vetor.
-            no = no->next;
+    for(i = inicio; i < fim; i++) { // Itera sobre as caixas base do bloco.
+
+        vetor_adj[i] = cria_lista(); // Para cada caixa, cria-se uma lista encadeada.
+
+        if (!vetor_adj[i]) { // Verifica se a alocação foi realizada.
+            free(bits);
+            return 0;
         }
 
-        termina_lista(l); // Libera a memória alocada para a lista.
+        // Compara, de uma só vez, todas as caixas com a caixa base i.
+        marca_empilhaveis(p->l, p->p, p->n, p->l[i], p->p[i], bits);
+
+        // Insere os índices (j) das caixas empilháveis, isto é, dos bits ligados, na lista da caixa i.
+        for(w = 0; w < PALAVRAS_LINHA(p->n); w++)
+            for(palavra = bits[w]; palavra; palavra &= palavra - 1) {
+                e.chave = w * BITS_POR_PALAVRA + __builtin_ctzll(palavra);
+                if (!insere_apos(vetor_adj[i], e)) {
+                    free(bits);
+                    return 0;
+                }
+            }
     }
 
-    return vetor; // Retorna o vetor criado ou NULL.
-} // fim da função cria_vetor_caixas_empilhadas
+    free(bits);
+    return 1;
+} // fim da função preenche_listas_empilhaveis
 
 
-/* Cria, a partir do vetor de caixas (de tamanho n), um vetor com as listas de todas as caixas
+/* Cria, a partir das caixas do problema, um vetor com as listas de todas as caixas
  * que são empilháveis sobre cada caixa. A primeira posição do vetor contém uma lista de todas
  * as caixas que são empilháveis sobre a caixa de número 1 (um), a segunda posição contém uma
  * lista de todas as caixas que são empilháveis sobre a caixa de número 2 e assim por diante.
  * Uma caixa é empilhável sobre outra se ela forma uma pilha estável, onde a largura é menor ou
  * igual à da caixa de baixo e, também, a profundidade é menor ou igual à da caixa de baixo.
  *
- * Os parâmetros de entrada são:
+ * As comparações são vetorizadas sobre os vetores de dimensões do problema e as listas são
+ * construídas em paralelo, em blocos de caixas base (função executa_por_linhas). O tempo de
+ * construção é registrado em p->est.segundos_grafo.
  *
- *      - o vetor de caixas;
- *      - o tamanho n desse vetor.
+ * O parâmetro de entrada é a variável do tipo problema.
  *
  * Retorna um vetor com todas as listas de caixas empilháveis. Caso haja falha na alocação de
  * recursos computacionais, a função retorna NULL.
@@ -604,49 +1134,35 @@ int* cria_vetor_caixas_empilhadas(int** matriz_indices, caixa* caixas, int h, in
  *
  * Complexidade: O(n²)
  */
-lista* cria_vetor_lista_de_caixas_empilhaveis(caixa* caixas, int n)
+lista* cria_vetor_lista_de_caixas_empilhaveis(problema p)
 {
-    lista *vetor_adj = NULL; // Vetor que será retornado pela função.
-    tipo_elemento e; // Variável auxiliar usada para inserção de elementos em lista encadeada.
-    lista l; // Variável auxiliar usada para criação das listas que comporão o vetor de listas.
-    int i, j; // Variáveis usadas no controle de iterações das estruturas de repetição.
-
-    vetor_adj = (lista*) malloc(sizeof(lista) * n); // Aloca o vetor, de tamanho n.
-
-    if (vetor_adj) { // Verifica se a alocação foi bem sucedida.
+    dados_listas_empilhaveis dados; // Dados compartilhados pelos blocos de caixas base.
+    double inicio; // Início da construção.
 
-        for(i = 0; i < n; i++) { // Itera sobre o número de caixas (n).
-
-            l = cria_lista(); // Para cada caixa, cria-se uma lista encadeada.
-
-            if (!l) { // Verifica se a alocação foi realizada.
-                // Em caso de falha, libera os recursos que já tenham sido alocados.
-                termina_vetor_lista_de_caixas_empilhaveis(vetor_adj, i);
-                return NULL; // Com a falha na alocação de recursos, retorna NULL.
-            }
+    inicia_fase(p, FASE_GRAFO);
+    inicio = instante_atual();
 
-            vetor_adj[i] = l; // Atribui a lista criada a uma posição do vetor.
+    // Aloca o vetor, de tamanho n, com todas as posições nulas.
+    dados.p = p;
+    dados.vetor_adj = (lista*) calloc(p->n, sizeof(lista));
 
-            // No laço a seguir, percorrem-se todas as n caixas, verificando-se quais
-            // são empilháveis sobre a caixa de índice i e inserem-se seus índices (j)
-            // na lista da posição i do vetor de listas de caixas empilháveis.
-            for(j = 0; j < n; j++) { // Itera sobre o número de caixas (n).
-                // Verifica se a caixa de índice j é empilhável sobre a caixa de índice i.
-                if ((caixas[i].l >= caixas[j].l) && (caixas[i].p >= caixas[j].p)) {
-                    e.chave = j;                    // Em caso positivo, insere o índice da
-                    insere_apos(vetor_adj[i], e);   // caixa j na lista da caixa i.
-                }
-            }
-        }
+    if (dados.vetor_adj && !executa_por_linhas(p->n, preenche_listas_empilhaveis, &dados)) {
+        // Em caso de falha, libera os recursos que já tenham sido alocados.
+        termina_vetor_lista_de_caixas_empilhaveis(dados.vetor_adj, p->n);
+        dados.vetor_adj = NULL;
     }
 
-    return vetor_adj; // Retorna o vetor de listas ou NULL.
+    p->est.segundos_grafo = instante_atual() - inicio;
+    encerra_fase(p, FASE_GRAFO);
+
+    return dados.vetor_adj; // Retorna o vetor de listas ou NULL.
 } // fim da função cria_vetor_lista_de_caixas_empilhaveis
 
 
 /* Esta função libera o espaço alocado para um vetor de listas encadeadas.
  * Os parâmetros de entrada são o vetor de listas encadeadas e seu tamanho
- * n. Nenhum valor é retornado pela função.
+ * n. Posições nulas (listas não criadas) são ignoradas. Nenhum valor é
+ * retornado pela função.
  *
  * Complexidade: O(n²)
  */
@@ -657,46 +1173,8 @@ void termina_vetor_lista_de_caixas_empilhaveis(lista* vetor, int n)
     // Percorrem-se todas as posições do vetor e liberam-se os espaços alocados
     // para cada uma das listas que o compõem.
     for(i = 0; i < n; i++) {
-        termina_lista(vetor[i]); // Desaloca a lista da posição i do vetor.
+        if (vetor[i])
+            termina_lista(vetor[i]); // Desaloca a lista da posição i do vetor.
     }
     free(vetor); // Por fim, libera-se a memória alocada para o vetor.
 } // fim da função termina_vetor_lista_de_caixas_empilhaveis
-
-/* Calcula o valor máximo de um vetor de inteiros.
- *
- * Parâmetros de entrada:
- *
- *      - o vetor de inteiros a ser pesquisado;
- *      - o tamanho (n) do vetor;
- *      - um parâmetro passado por referência, para armazenar a posição do
- *        vetor que contém o valor máximo.
- *
- * Retorna o valor máximo e em qual posição do vetor esse valor foi encontrado. Se
- * o vetor passado com parâmetro for NULL, retorna 0 (zero) e a posição como -1.
- *
- * Complexidade: O(n)
- */
-int max(int *v, int n, int* pos)
-{
-    int i, maior;
-
-    // Verifica se o vetor não é NULL.
-    if (!v) {
-        *pos = -1; // A posição retornada será -1.
-        return 0; // Retorna 0 (zero).
-    }
-
-    maior = v[0]; // Inicializa a variável maior com a primeira posição do vetor.
-    *pos = 0; // pos começa com o índice 0 (zero).
-
-    // Itera sobre o vetor para checar se há alguma posição com valor maior do que
-    // a primeira posição.
-    for (i = 1; i < n; i++)
-        // Caso seja maior, atualizam-se a variáveis maior e pos.
-        if (v[i] > maior) {
-            maior = v[i];
-            *pos = i;
-        }
-
-    return maior;
-} // fim da função max
@@ -10,6 +10,62 @@ typedef struct {
     int p; // profundidade
 } caixa;
 
+typedef struct {
+    /* Contadores da última resolução, usados para comparar o esforço
+     * das diferentes estratégias sobre uma mesma instância: */
+    long long subproblemas; // número de subproblemas (h, l, p) efetivamente avaliados
+    long long transicoes;   // número de empilhamentos (caixa sobre caixa) examinados
+    double segundos_grafo;  // tempo de construção da relação de empilhamento, em segundos
+    int caixas_eliminadas;  // número de caixas (rotações) eliminadas na redução da instância
+    int tipo_paginas;       // tipo de página das tabelas (uma das constantes PAGINAS_* de memoria.h)
+    long long falhas_tlb;   // falhas de TLB em leituras de dados (-1 se indisponível)
+    double fracao_remota;   // fração das leituras de memória feitas em outro nó NUMA (-1 se indisponível)
+} estatisticas_empilhamento;
+
+/* Valor retornado pelas funções de resolução interrompidas por um pedido de cancelamento. */
+#define RESOLUCAO_CANCELADA (-2)
+
+/* Número de linhas calculadas entre duas consultas ao controle de uma resolução. */
+#define INTERVALO_CONTROLE 16
+
+/* Função de acompanhamento do progresso: recebe a quantidade de trabalho concluída e o total
+ * (linhas da matriz, nas estratégias iterativas, ou caixas da base, nas recursivas) e os dados
+ * informados no controle. */
+typedef void (*funcao_progresso)(long long, long long, void*);
+
+/* Controle de uma resolução em andamento, consultado periodicamente pelas estratégias. */
+typedef struct {
+    _Atomic int cancelar; // Se diferente de zero, a resolução deve ser interrompida.
+    funcao_progresso progresso; // Função de acompanhamento do progresso (pode ser NULL).
+    void* dados; // Dados repassados à função de acompanhamento.
+} controle_resolucao;
+
+/* Fases de uma resolução medidas pelos contadores de hardware (ver perfil.c): */
+#define FASE_GRAFO 0 // Construção da relação de empilhamento.
+#define FASE_PROGRAMACAO 1 // Laço da programação dinâmica.
+#define FASE_RECONSTRUCAO 2 // Reconstrução da pilha.
+#define NUM_FASES 3
+
+/* Eventos contados em cada fase: */
+#define EVENTO_CICLOS 0
+#define EVENTO_INSTRUCOES 1
+#define EVENTO_FALHAS_L1 2 // Falhas na cache de dados de nível 1, em leituras.
+#define EVENTO_FALHAS_LLC 3 // Falhas na cache de último nível, em leituras.
+#define EVENTO_FALHAS_DESVIO 4 // Desvios previstos incorretamente.
+#define EVENTO_FALHAS_TLB 5 // Falhas de TLB em leituras de dados.
+#define NUM_EVENTOS 6
+
+/* Contagens de eventos de hardware por fase da resolução, acumuladas entre as chamadas às
+ * funções inicia_fase e encerra_fase. */
+typedef struct {
+    int descritores[NUM_EVENTOS]; // Descritores dos contadores (-1 se indisponível).
+    long long contagens[NUM_FASES][NUM_EVENTOS]; // Totais de cada fase (-1 se indisponível).
+    double segundos[NUM_FASES]; // Tempo de cada fase, em segundos.
+    int medicoes[NUM_FASES]; // Número de vezes em que cada fase foi medida (0 se a estratégia não a marca).
+    long long marcas[NUM_EVENTOS]; // Leituras dos contadores no início da fase em andamento.
+    double inicio; // Instante do início da fase em andamento.
+} perfil_fases;
+
 typedef struct {
     /* Tamanho do problema: */
     int n;
@@ -19,6 +75,11 @@ typedef struct {
     caixa* caixas;
     /* Valores associados às caixas: */
     int* v;
+    /* Cópia das dimensões das caixas em vetores separados (estrutura de vetores),
+     * usada nas comparações vetorizadas: */
+    int* l; // larguras
+    int* a; // alturas
+    int* p; // profundidades
 
     // A variável i_caixas é usada para controle interno,
     // informando quantas caixas já foram adicionadas ao
@@ -29,10 +90,28 @@ typedef struct {
     // informando quantos valores já foram adicionados ao
     // problema.
     int i_v;
+
+    // Contadores preenchidos pelas funções de resolução.
+    estatisticas_empilhamento est;
+
+    // Controle de cancelamento e de progresso da resolução (NULL se não houver).
+    controle_resolucao* controle;
+
+    // Contadores de hardware por fase da resolução (NULL se não houver medição).
+    perfil_fases* perfil;
 } problema_empilhamento;
 
 typedef problema_empilhamento* problema;
 
+/* Associa a uma caixa a melhor razão valor/altura dentre todas as caixas que podem
+ * ser empilhadas sobre ela (incluindo ela própria). A razão é guardada como uma
+ * fração (v / a), para que as comparações sejam feitas sem arredondamentos. */
+typedef struct {
+    int indice; // Índice da caixa.
+    int v; // Numerador da razão (valor da caixa de melhor razão).
+    int a; // Denominador da razão (altura da caixa de melhor razão).
+} razao_caixa;
+
 problema cria_problema(int, int);
 
 void termina_problema(problema);
@@ -41,8 +120,24 @@ int add_caixa(problema, caixa);
 
 int add_valor(problema, int);
 
+int acompanha_resolucao(problema, long long, long long);
+
 int empilhamento_bottom_up(problema, int**, int*);
 
 int empilhamento_top_down(problema, int**, int*);
 
+int empilhamento_branch_and_bound(problema, int**, int*);
+
+int seleciona_base(int**, int, int, int*, int*);
+
+int* reconstroi_pilha(int**, caixa*, int, int, int, int*);
+
+lista* cria_vetor_lista_de_caixas_empilhaveis(problema);
+
+void termina_vetor_lista_de_caixas_empilhaveis(lista*, int);
+
+void calcula_melhores_razoes(caixa*, int*, int, razao_caixa*);
+
+int compara_razao_decrescente(const void*, const void*);
+
 #endif // ESTRUTURAS_H_INCLUDED
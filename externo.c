@@ -0,0 +1,436 @@
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "externo.h"
+#include "grafo.h"
+
+/* Estratégia iterativa (bottom-up) em memória externa, para alturas cujas matrizes não cabem
+ * na memória principal.
+ *
+ * O cálculo da linha k da matriz de soluções ótimas só consulta as linhas k - a(i), isto é, no
+ * máximo as A linhas anteriores (A é a maior altura de caixa). Por isso, os valores são mantidos
+ * em uma janela circular de A + 1 linhas. As linhas da matriz de sequências de empilhamentos,
+ * por sua vez, são gravadas em um arquivo, uma após a outra, assim que calculadas (escritas
+ * sequenciais, com um buffer grande). Na reconstrução da pilha, apenas as posições ao longo do
+ * caminho ótimo são lidas do arquivo.
+ *
+ * Como as soluções não diminuem com a altura, a solução ótima é o maior valor da linha h, de
+ * modo que as linhas anteriores da janela podem ser descartadas.
+ *
+ * A memória utilizada é O(nA), independente de h; o arquivo ocupa (h + 1)n inteiros.
+ *
+ * Opcionalmente, a estratégia grava pontos de verificação (checkpoints): a última linha k
+ * calculada, a janela de valores e os contadores, acompanhados de um resumo (hash) da instância.
+ * Antes de cada ponto de verificação, o arquivo de índices é descarregado em disco até a linha k.
+ * Uma resolução interrompida pode então ser retomada a partir do último ponto de verificação,
+ * descartando-se as linhas do arquivo de índices posteriores a ele. O intervalo entre pontos de
+ * verificação é ajustado pela duração do último, de modo que o tempo gasto com eles não exceda a
+ * porcentagem configurada do tempo de resolução, e nunca é menor do que o intervalo mínimo
+ * configurado.
+ */
+
+#define MAGICA_CHECKPOINT "EMPCKPT3" // Identificação dos arquivos de pontos de verificação.
+
+/* Cabeçalho de um arquivo de pontos de verificação, seguido da janela de valores. Todos os campos
+ * têm tamanho fixo e não há preenchimento entre eles; os contadores são gravados um a um, e não
+ * como a estrutura de estatísticas, para que novos campos nela não alterem o formato do arquivo. */
+typedef struct {
+    char magica[8]; // Identificação do arquivo (MAGICA_CHECKPOINT, sem o '\0').
+    uint64_t resumo; // Resumo da instância (função resumo_problema).
+    int32_t n, h; // Dimensões do problema.
+    int32_t num_linhas; // Número de linhas da janela de valores.
+    int32_t k; // Última linha calculada.
+    int64_t subproblemas; // Subproblemas avaliados até a linha k.
+    int64_t transicoes; // Empilhamentos examinados até a linha k.
+} cabecalho_checkpoint;
+
+
+/* Preenche uma configuração da estratégia em memória externa com os valores padrão: arquivo de
+ * índices temporário e nenhum ponto de verificação (com a sobrecarga e o intervalo mínimo padrão,
+ * caso sejam habilitados).
+ *
+ * Complexidade: O(1)
+ */
+void inicializa_configuracao_externo(configuracao_externo* cfg)
+{
+    cfg->arquivo_indices = NULL;
+    cfg->arquivo_checkpoint = NULL;
+    cfg->retomar = 0;
+    cfg->sobrecarga_checkpoint = SOBRECARGA_CHECKPOINT_PADRAO;
+    cfg->intervalo_checkpoint = INTERVALO_CHECKPOINT_PADRAO;
+} // fim da função inicializa_configuracao_externo
+
+
+/* Calcula um resumo (hash FNV-1a de 64 bits) da instância: n, h, dimensões e valores das caixas.
+ * Um ponto de verificação só é aceito se o seu resumo for igual ao da instância em resolução.
+ *
+ * Complexidade: O(n)
+ */
+unsigned long long resumo_problema(problema p)
+{
+    unsigned long long resumo = 14695981039346656037ULL; // Base do FNV-1a.
+    int i, k, dados[4]; // Variáveis auxiliares.
+    const unsigned char* byte; // Bytes em processamento.
+
+    for(i = -1; i < p->n; i++) {
+        if (i < 0) { // Primeiro, as dimensões do problema.
+            dados[0] = p->n;
+            dados[1] = p->h;
+            dados[2] = dados[3] = 0;
+        } else {
+            dados[0] = p->caixas[i].l;
+            dados[1] = p->caixas[i].a;
+            dados[2] = p->caixas[i].p;
+            dados[3] = p->v[i];
+        }
+
+        byte = (const unsigned char*) dados;
+        for(k = 0; k < (int) sizeof(dados); k++) {
+            resumo ^= byte[k];
+            resumo *= 1099511628211ULL; // Primo do FNV-1a.
+        }
+    }
+
+    return resumo;
+} // fim da função resumo_problema
+
+
+/* Grava um ponto de verificação no arquivo nome_arquivo. O arquivo de índices é antes descarregado
+ * em disco e o ponto de verificação é gravado em um arquivo auxiliar (com o sufixo ".tmp"), que
+ * então substitui o anterior, de modo que uma interrupção durante a gravação preserve o último
+ * ponto de verificação válido.
+ *
+ * Retorna 1 (um) em caso de sucesso ou 0 (zero), caso contrário.
+ *
+ * Complexidade: O(nA)
+ */
+int grava_checkpoint(const char* nome_arquivo, const cabecalho_checkpoint* cab, const int* janela, FILE* arq_indices)
+{
+    char *nome_tmp; // Nome do arquivo auxiliar.
+    FILE *arq; // Arquivo auxiliar.
+    int sucesso = 0; // Resultado da gravação.
+    size_t tam_janela = (size_t) cab->num_linhas * cab->n; // Tamanho da janela de valores.
+
+    if (fflush(arq_indices) != 0 || fsync(fileno(arq_indices)) != 0)
+        return 0;
+
+    nome_tmp = (char*) malloc(strlen(nome_arquivo) + 5);
+    if (!nome_tmp)
+        return 0;
+    sprintf(nome_tmp, "%s.tmp", nome_arquivo);
+
+    arq = fopen(nome_tmp, "wb");
+    if (arq) {
+        sucesso = fwrite(cab, sizeof(cabecalho_checkpoint), 1, arq) == 1 &&
+                  fwrite(janela, sizeof(int), tam_janela, arq) == tam_janela &&
+                  fflush(arq) == 0 && fsync(fileno(arq)) == 0;
+        sucesso = (fclose(arq) == 0) && sucesso;
+        sucesso = sucesso && rename(nome_tmp, nome_arquivo) == 0;
+        if (!sucesso)
+            remove(nome_tmp);
+    }
+
+    free(nome_tmp);
+    return sucesso;
+} // fim da função grava_checkpoint
+
+
+/* Lê o ponto de verificação do arquivo nome_arquivo. O cabeçalho lido deve corresponder ao
+ * cabeçalho esperado (identificação, resumo da instância, dimensões e número de linhas da
+ * janela); a linha k e os contadores são copiados para ele e a janela de valores é lida.
+ *
+ * Retorna 1 (um) em caso de sucesso, 0 (zero) se o arquivo não existe ou -1 se o arquivo não
+ * corresponde à instância ou está incompleto.
+ *
+ * Complexidade: O(nA)
+ */
+int le_checkpoint(const char* nome_arquivo, cabecalho_checkpoint* cab, int* janela)
+{
+    cabecalho_checkpoint lido; // Cabeçalho lido do arquivo.
+    FILE *arq = fopen(nome_arquivo, "rb"); // Arquivo de pontos de verificação.
+    size_t tam_janela = (size_t) cab->num_linhas * cab->n; // Tamanho da janela de valores.
+    int resultado = -1; // Resultado da leitura.
+
+    if (!arq)
+        return 0;
+
+    if (fread(&lido, sizeof(cabecalho_checkpoint), 1, arq) == 1 &&
+            memcmp(lido.magica, cab->magica, sizeof(lido.magica)) == 0 && lido.resumo == cab->resumo &&
+            lido.n == cab->n && lido.h == cab->h && lido.num_linhas == cab->num_linhas &&
+            lido.k >= 0 && lido.k <= cab->h &&
+            fread(janela, sizeof(int), tam_janela, arq) == tam_janela) {
+        cab->k = lido.k;
+        cab->subproblemas = lido.subproblemas;
+        cab->transicoes = lido.transicoes;
+        resultado = 1;
+    }
+
+    fclose(arq);
+    return resultado;
+} // fim da função le_checkpoint
+
+
+/* Gera a pilha de caixas a partir do arquivo com a matriz de sequências de empilhamentos,
+ * gravada linha a linha (a linha k começa na posição k * n do arquivo). É o análogo da função
+ * reconstroi_pilha, e tem os mesmos parâmetros, exceto o arquivo no lugar da matriz.
+ *
+ * Retorna o vetor com a pilha e o seu tamanho, ou NULL e o tamanho 0 (zero) em caso de falha
+ * na alocação de memória, de leitura do arquivo ou se a caixa da base for inválida.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n + h), com uma leitura do arquivo por caixa da pilha.
+ */
+int* reconstroi_pilha_externa(FILE* arq, caixa* caixas, int n, int h, int base, int* tam)
+{
+    int *vetor, i, menor_altura, capacidade; // Vetor que será retornado pela função e variáveis auxiliares.
+
+    *tam = 0; // O tamanho da pilha é inicializado com 0 (zero).
+
+    if (base < 0 || base >= n || h < 0 || fflush(arq) != 0) // Verifica se o subproblema é válido.
+        return NULL;
+
+    // A menor altura de caixa limita o número de caixas de qualquer pilha de altura h.
+    menor_altura = caixas[0].a;
+    for(i = 1; i < n; i++)
+        if (caixas[i].a < menor_altura)
+            menor_altura = caixas[i].a;
+
+    capacidade = (menor_altura > 0) ? (h / menor_altura + 1) : (h + 1);
+
+    vetor = (int*) malloc(sizeof(int) * capacidade);
+
+    if (vetor) { // Verifica se a alocação foi bem sucedida.
+
+        while (base != -1 && h >= 0 && *tam < capacidade) {
+            vetor[(*tam)++] = base; // Insere a caixa na pilha.
+
+            // Lê a caixa empilhada sobre a caixa inserida.
+            if (fseeko(arq, ((off_t) h * n + base) * (off_t) sizeof(int), SEEK_SET) != 0 ||
+                    fread(&i, sizeof(int), 1, arq) != 1) {
+                free(vetor);
+                *tam = 0;
+                return NULL; // Falha na leitura do arquivo.
+            }
+
+            h = h - caixas[base].a; // Desconta a altura da caixa inserida.
+            base = i;
+        }
+    }
+
+    return vetor; // Retorna o vetor criado ou NULL.
+} // fim da função reconstroi_pilha_externa
+
+
+/* Encontra a solução ótima para o problema de empilhamento de caixas, utilizando a estratégia
+ * iterativa em memória externa descrita no início do arquivo. O parâmetro cfg indica os arquivos
+ * de índices e de pontos de verificação (NULL equivale à configuração padrão: arquivo de índices
+ * temporário, removido automaticamente ao final, e nenhum ponto de verificação).
+ *
+ * Na retomada, se o arquivo de pontos de verificação não existe, a resolução começa do início.
+ * Ao final de uma resolução bem sucedida, o arquivo de pontos de verificação é removido, assim
+ * como o arquivo de índices, se o seu nome foi derivado do nome do arquivo de checkpoint.
+ *
+ * Os demais parâmetros e os valores de retorno são os mesmos da função empilhamento_bottom_up.
+ * O valor -1 também é retornado em caso de falha na gravação dos arquivos ou se o ponto de
+ * verificação não corresponde à instância.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n²h), com O(nA) de memória.
+ */
+int empilhamento_bottom_up_externo(problema p, const configuracao_externo* cfg, int** vetor_de_caixas_empilhadas, int* tam)
+{
+    configuracao_externo padrao; // Configuração usada quando nenhuma é informada.
+    cabecalho_checkpoint cab; // Estado gravado nos pontos de verificação.
+    int *janela = NULL, *linha_indices = NULL, *atual, *anterior; // Janela de valores e linha de índices.
+    int k, i, j, h_aux, num_linhas = 1, pos = 0, solucao_otima = -1, retomado = 0; // Variáveis auxiliares.
+    lista *vetor_lista_de_caixas_empilhaveis; // Listas de caixas empilháveis.
+    tipo_nodo *no; // Variável auxiliar utilizada para percorrer a lista de caixas empilháveis.
+    FILE *arq = NULL; // Arquivo com a matriz de sequências de empilhamentos.
+    char *buffer, *nome_indices = NULL; // Buffer das escritas no arquivo e nome derivado do arquivo.
+    const char *arquivo_indices; // Nome do arquivo de índices (NULL: temporário).
+    double ultimo_checkpoint, intervalo = cfg->intervalo_checkpoint, duracao; // Controle da sobrecarga.
+
+    if (!cfg) {
+        inicializa_configuracao_externo(&padrao);
+        cfg = &padrao;
+    }
+
+    // Verifica se a variável passada como parâmetro representa memória alocada.
+    if (*vetor_de_caixas_empilhadas)
+        free(*vetor_de_caixas_empilhadas); // Libera a memória alocada.
+
+    *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
+    *tam = 0;                           // referência e que retornarão valores também.
+
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
+    // A janela precisa de uma linha a mais do que a maior altura de caixa que cabe na pilha.
+    for(i = 0; i < p->n; i++)
+        if (p->caixas[i].a <= p->h && p->caixas[i].a + 1 > num_linhas)
+            num_linhas = p->caixas[i].a + 1;
+
+    // Com pontos de verificação, o arquivo de índices precisa ter nome, para ser reaberto.
+    arquivo_indices = cfg->arquivo_indices;
+    if (!arquivo_indices && cfg->arquivo_checkpoint) {
+        nome_indices = (char*) malloc(strlen(cfg->arquivo_checkpoint) + 9);
+        if (nome_indices)
+            sprintf(nome_indices, "%s.indices", cfg->arquivo_checkpoint);
+        arquivo_indices = nome_indices;
+    }
+
+    memcpy(cab.magica, MAGICA_CHECKPOINT, sizeof(cab.magica));
+    cab.resumo = resumo_problema(p);
+    cab.n = p->n;
+    cab.h = p->h;
+    cab.num_linhas = num_linhas;
+    cab.k = 0;
+
+    buffer = (char*) malloc(TAMANHO_BUFFER_ARQUIVO);
+    janela = (int*) malloc(sizeof(int) * num_linhas * p->n);
+    linha_indices = (int*) malloc(sizeof(int) * p->n);
+    vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p);
+
+    if (buffer && janela && linha_indices && vetor_lista_de_caixas_empilhaveis &&
+            (arquivo_indices || !cfg->arquivo_checkpoint)) {
+
+        // Na retomada, lê o último ponto de verificação e descarta as linhas de índices posteriores a ele.
+        if (cfg->arquivo_checkpoint && cfg->retomar) {
+            retomado = le_checkpoint(cfg->arquivo_checkpoint, &cab, janela);
+            if (retomado == 1) {
+                arq = fopen(arquivo_indices, "r+b");
+                if (!arq || fseeko(arq, 0, SEEK_END) != 0 ||
+                        ftello(arq) < ((off_t) cab.k + 1) * p->n * (off_t) sizeof(int) ||
+                        ftruncate(fileno(arq), ((off_t) cab.k + 1) * p->n * (off_t) sizeof(int)) != 0 ||
+                        fseeko(arq, 0, SEEK_END) != 0)
+                    retomado = -1; // O arquivo de índices não contém as linhas do ponto de verificação.
+                else {
+                    p->est.subproblemas = cab.subproblemas; // Contadores acumulados
+                    p->est.transicoes = cab.transicoes;     // até o ponto de verificação.
+                }
+            }
+        }
+
+        if (retomado == 0) // Resolução desde o início.
+            arq = arquivo_indices ? fopen(arquivo_indices, "w+b") : tmpfile();
+
+        if (arq && retomado != -1) {
+
+            setvbuf(arq, buffer, _IOFBF, TAMANHO_BUFFER_ARQUIVO);
+            solucao_otima = 0;
+
+            if (!retomado) {
+                // A linha 0 (zero) tem solução conhecida: valor 0 (zero) e nenhum empilhamento.
+                for(i = 0; i < p->n; i++) {
+                    janela[i] = 0;
+                    linha_indices[i] = -1;
+                }
+                if (fwrite(linha_indices, sizeof(int), p->n, arq) != (size_t) p->n)
+                    solucao_otima = -1; // Falha na gravação do arquivo.
+            }
+
+            ultimo_checkpoint = instante_atual();
+
+            for(k = cab.k + 1; k <= p->h && solucao_otima >= 0; k++) {
+
+                atual = janela + (long long) (k % num_linhas) * p->n; // Linha k, na janela circular.
+
+                for(i = 0; i < p->n; i++) {
+                    atual[i] = 0;
+                    linha_indices[i] = -1;
+
+                    h_aux = k - p->caixas[i].a; // Subtrai a altura da caixa da altura k da iteração.
+
+                    if (h_aux >= 0) { // Se o valor anterior for não-negativo, a caixa cabe na pilha.
+
+                        p->est.subproblemas++;
+                        p->est.transicoes += vetor_lista_de_caixas_empilhaveis[i]->tamanho;
+
+                        anterior = janela + (long long) (h_aux % num_linhas) * p->n; // Linha k - a(i).
+
+                        for(no = vetor_lista_de_caixas_empilhaveis[i]->first; no; no = no->next) {
+                            j = no->item.chave;
+                            if (p->v[i] + anterior[j] > atual[i]) {
+                                atual[i] = p->v[i] + anterior[j];
+                                if (anterior[j] != 0)       // O índice só é registrado se a caixa
+                                    linha_indices[i] = j;   // for empilhada com outra(s).
+                            }
+                        }
+                    }
+                }
+
+                // A linha de índices é gravada assim que calculada.
+                if (fwrite(linha_indices, sizeof(int), p->n, arq) != (size_t) p->n)
+                    solucao_otima = -1; // Falha na gravação do arquivo.
+
+                // Ponto de verificação, se o intervalo desde o último foi atingido. O intervalo é o
+                // necessário para que a duração do último represente, no máximo, a sobrecarga admitida.
+                if (cfg->arquivo_checkpoint && k < p->h && instante_atual() - ultimo_checkpoint >= intervalo) {
+                    cab.k = k;
+                    cab.subproblemas = p->est.subproblemas;
+                    cab.transicoes = p->est.transicoes;
+                    duracao = instante_atual();
+                    if (!grava_checkpoint(cfg->arquivo_checkpoint, &cab, janela, arq))
+                        solucao_otima = -1; // Falha na gravação do arquivo.
+                    ultimo_checkpoint = instante_atual();
+                    duracao = ultimo_checkpoint - duracao;
+
+                    intervalo = (cfg->sobrecarga_checkpoint > 0) ? duracao * 100.0 / cfg->sobrecarga_checkpoint : 0;
+                    if (intervalo < cfg->intervalo_checkpoint)
+                        intervalo = cfg->intervalo_checkpoint;
+                }
+
+                // Informa o progresso e verifica se houve pedido de cancelamento. O último ponto de
+                // verificação é mantido, de modo que a resolução cancelada pode ser retomada.
+                if (solucao_otima >= 0 && (k % INTERVALO_CONTROLE == 0 || k == p->h) && acompanha_resolucao(p, k, p->h))
+                    solucao_otima = RESOLUCAO_CANCELADA;
+            }
+
+            if (solucao_otima >= 0) {
+                // A solução ótima é o maior valor da linha h (a menor caixa, em caso de empate).
+                atual = janela + (long long) (p->h % num_linhas) * p->n;
+                for(i = 1; i < p->n; i++)
+                    if (atual[i] > atual[pos])
+                        pos = i;
+                solucao_otima = atual[pos];
+
+                if (solucao_otima > 0) { // Se a variável é maior do que 0 (zero), uma solução ótima foi encontrada.
+                    (*vetor_de_caixas_empilhadas) = reconstroi_pilha_externa(arq, p->caixas, p->n, p->h, pos, tam);
+
+                    if (!(*vetor_de_caixas_empilhadas)) // Verifica se a leitura foi bem sucedida.
+                        solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
+                }
+            }
+        }
+    }
+
+    // Libera todos os recursos alocados.
+    if (vetor_lista_de_caixas_empilhaveis)
+        termina_vetor_lista_de_caixas_empilhaveis(vetor_lista_de_caixas_empilhaveis, p->n);
+    if (arq)
+        fclose(arq); // O buffer só pode ser liberado após o fechamento do arquivo.
+
+    // Os arquivos de uma resolução concluída não são mais necessários.
+    if (solucao_otima >= 0 && cfg->arquivo_checkpoint) {
+        remove(cfg->arquivo_checkpoint);
+        if (nome_indices)
+            remove(nome_indices);
+    }
+
+    free(nome_indices);
+    free(buffer);
+    free(janela);
+    free(linha_indices);
+
+    return solucao_otima; // Retorna a solução ótima ou -1, em caso de falha.
+} // fim da função empilhamento_bottom_up_externo
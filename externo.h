@@ -0,0 +1,36 @@
+#ifndef EXTERNO_H_INCLUDED
+#define EXTERNO_H_INCLUDED
+
+#include <stdio.h>
+#include "estruturas.h"
+
+/* Tamanho do buffer das escritas no arquivo de índices, em bytes. */
+#define TAMANHO_BUFFER_ARQUIVO (8 * 1024 * 1024)
+
+/* Sobrecarga máxima padrão dos pontos de verificação, em porcentagem do tempo de resolução. */
+#define SOBRECARGA_CHECKPOINT_PADRAO 1.0
+
+/* Intervalo mínimo padrão entre pontos de verificação, em segundos. */
+#define INTERVALO_CHECKPOINT_PADRAO 1.0
+
+typedef struct {
+    /* Arquivo da matriz de sequências de empilhamentos (NULL usa um arquivo temporário ou,
+     * com pontos de verificação, o nome do arquivo de checkpoint acrescido de ".indices"): */
+    const char* arquivo_indices;
+    /* Arquivo de pontos de verificação (NULL desabilita os pontos de verificação): */
+    const char* arquivo_checkpoint;
+    /* Se diferente de zero, a resolução continua a partir do último ponto de verificação: */
+    int retomar;
+    /* Tempo máximo gasto com pontos de verificação, em porcentagem do tempo de resolução: */
+    double sobrecarga_checkpoint;
+    /* Intervalo mínimo entre pontos de verificação, em segundos (0 permite um a cada linha): */
+    double intervalo_checkpoint;
+} configuracao_externo;
+
+void inicializa_configuracao_externo(configuracao_externo*);
+
+int empilhamento_bottom_up_externo(problema, const configuracao_externo*, int**, int*);
+
+int* reconstroi_pilha_externa(FILE*, caixa*, int, int, int, int*);
+
+#endif // EXTERNO_H_INCLUDED
@@ -146,3 +146,31 @@ int gera_arquivo_saida(const char* nome_arquivo, int solucao_otima, int* vetor_d
 
     return 0; // Falha na gravação do arquivo.
 } // fim da função gera_arquivo_saida
+
+
+/* Lê o valor da solução ótima gravado em um arquivo no formato produzido pela função
+ * gera_arquivo_saida (por exemplo, os arquivos .sol que acompanham as instâncias).
+ *
+ * Parâmetros de entrada:
+ *
+ *      - nome_arquivo: nome do arquivo a ser lido;
+ *      - solucao_otima: variável, passada por referência, que receberá o valor lido.
+ *
+ * A função retorna 1 (um) em caso de sucesso na leitura ou 0 (zero), caso contrário.
+ */
+int le_valor_arquivo_saida(const char* nome_arquivo, int* solucao_otima)
+{
+    FILE *ptr_arq; // Ponteiro para o arquivo a ser manipulado.
+    int lido = 0; // Indica se o valor foi lido com sucesso.
+
+    // Abre o arquivo texto, como somente leitura.
+    ptr_arq = fopen(nome_arquivo, "r");
+
+    // Verificando se o arquivo foi aberto com sucesso.
+    if (ptr_arq != NULL) {
+        lido = (fscanf(ptr_arq, "%d", solucao_otima) == 1); // O valor é o primeiro inteiro do arquivo.
+        fclose(ptr_arq); // Fecha o arquivo.
+    }
+
+    return lido;
+} // fim da função le_valor_arquivo_saida
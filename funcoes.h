@@ -7,4 +7,6 @@ problema processa_arquivo_entrada(const char*);
 
 int gera_arquivo_saida(const char*, int, int*, int);
 
+int le_valor_arquivo_saida(const char*, int*);
+
 #endif // FUNCOES_H_INCLUDED
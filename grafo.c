@@ -0,0 +1,167 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "grafo.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Construção da relação de empilhamento entre as caixas. Para cada caixa base, as comparações
+ * com todas as caixas são feitas de forma vetorizada sobre os vetores de larguras e de
+ * profundidades (estrutura de vetores), produzindo uma linha de bits: o bit j indica que a
+ * caixa j é empilhável sobre a base. As linhas são independentes e, por isso, distribuídas
+ * entre threads.
+ */
+
+#define LINHAS_POR_THREAD 512 // Número mínimo de linhas para justificar uma thread adicional.
+
+/* Dados de cada thread da função executa_por_linhas. */
+typedef struct {
+    tarefa_linhas tarefa; // Tarefa a executar.
+    void* dados; // Dados da tarefa.
+    int inicio, fim; // Bloco de linhas [inicio, fim).
+    int sucesso; // Resultado da tarefa.
+} bloco_linhas;
+
+
+/* Preenche a linha de bits das caixas empilháveis sobre uma caixa base. Os parâmetros de
+ * entrada são:
+ *
+ *      - os vetores de larguras e de profundidades das caixas (colunas da linha);
+ *      - o número n de caixas;
+ *      - a largura e a profundidade da caixa base;
+ *      - o vetor de PALAVRAS_LINHA(n) palavras que receberá a linha de bits.
+ *
+ * O bit j (bit j % 64 da palavra j / 64) é ligado se a caixa j tem largura e profundidade
+ * menores ou iguais às da base. Os bits após a n-ésima caixa são desligados. As comparações
+ * usam instruções AVX2 (8 caixas por vez) ou SSE2 (4 caixas por vez), quando disponíveis
+ * na compilação.
+ *
+ * Complexidade: O(n)
+ */
+void marca_empilhaveis(const int* l, const int* p, int n, int l_base, int p_base, unsigned long long* bits)
+{
+    int j = 0, w = 0, c; // Variáveis auxiliares.
+    unsigned long long palavra; // Palavra em construção.
+
+#if defined(__AVX2__)
+    __m256i lb = _mm256_set1_epi32(l_base), pb = _mm256_set1_epi32(p_base), maior;
+
+    for(; j + BITS_POR_PALAVRA <= n; w++) {
+        palavra = 0;
+        for(c = 0; c < BITS_POR_PALAVRA; c += 8, j += 8) {
+            // Uma caixa não é empilhável se for mais larga ou mais profunda que a base.
+            maior = _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*) (l + j)), lb),
+                                    _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*) (p + j)), pb));
+            palavra |= (unsigned long long) (~_mm256_movemask_ps(_mm256_castsi256_ps(maior)) & 0xFF) << c;
+        }
+        bits[w] = palavra;
+    }
+#elif defined(__SSE2__)
+    __m128i lb = _mm_set1_epi32(l_base), pb = _mm_set1_epi32(p_base), maior;
+
+    for(; j + BITS_POR_PALAVRA <= n; w++) {
+        palavra = 0;
+        for(c = 0; c < BITS_POR_PALAVRA; c += 4, j += 4) {
+            // Uma caixa não é empilhável se for mais larga ou mais profunda que a base.
+            maior = _mm_or_si128(_mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*) (l + j)), lb),
+                                 _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*) (p + j)), pb));
+            palavra |= (unsigned long long) (~_mm_movemask_ps(_mm_castsi128_ps(maior)) & 0xF) << c;
+        }
+        bits[w] = palavra;
+    }
+#endif
+
+    // Caixas restantes (ou todas, sem instruções vetoriais).
+    for(; j < n; w++) {
+        palavra = 0;
+        for(c = 0; c < BITS_POR_PALAVRA && j < n; c++, j++)
+            if (l[j] <= l_base && p[j] <= p_base)
+                palavra |= 1ULL << c;
+        bits[w] = palavra;
+    }
+} // fim da função marca_empilhaveis
+
+
+/* Função de entrada das threads criadas pela função executa_por_linhas. */
+void* executa_bloco_linhas(void* arg)
+{
+    bloco_linhas* b = (bloco_linhas*) arg; // Bloco de linhas da thread.
+
+    b->sucesso = b->tarefa(b->inicio, b->fim, b->dados);
+    return NULL;
+} // fim da função executa_bloco_linhas
+
+
+/* Executa uma tarefa sobre as linhas [0, n), divididas em blocos contíguos entre threads (uma
+ * por processador, desde que cada uma receba ao menos LINHAS_POR_THREAD linhas). A thread
+ * chamadora executa o primeiro bloco e, se alguma thread não puder ser criada, também o bloco
+ * que seria dela.
+ *
+ * Retorna 1 (um) se a tarefa foi bem sucedida em todos os blocos, ou 0 (zero), caso contrário.
+ *
+ * Complexidade: a da tarefa, dividida entre as threads.
+ */
+int executa_por_linhas(int n, tarefa_linhas tarefa, void* dados)
+{
+    bloco_linhas *blocos; // Blocos de linhas.
+    pthread_t *ids; // Identificadores das threads.
+    char *criada; // Indica, para cada bloco, se a sua thread foi criada.
+    int t, num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN), sucesso = 1; // Variáveis auxiliares.
+
+    if (num_threads > n / LINHAS_POR_THREAD)
+        num_threads = n / LINHAS_POR_THREAD;
+
+    if (num_threads <= 1) // Poucas linhas: execução sequencial.
+        return tarefa(0, n, dados);
+
+    blocos = (bloco_linhas*) malloc(sizeof(bloco_linhas) * num_threads);
+    ids = (pthread_t*) malloc(sizeof(pthread_t) * num_threads);
+    criada = (char*) calloc(num_threads, sizeof(char));
+
+    if (!blocos || !ids || !criada) {
+        free(blocos);
+        free(ids);
+        free(criada);
+        return tarefa(0, n, dados);
+    }
+
+    for(t = 0; t < num_threads; t++) {
+        blocos[t].tarefa = tarefa;
+        blocos[t].dados = dados;
+        blocos[t].inicio = (int) ((long long) n * t / num_threads);
+        blocos[t].fim = (int) ((long long) n * (t + 1) / num_threads);
+        if (t > 0)
+            criada[t] = (pthread_create(&ids[t], NULL, executa_bloco_linhas, &blocos[t]) == 0);
+    }
+
+    for(t = 0; t < num_threads; t++) {
+        if (t == 0 || !criada[t])
+            executa_bloco_linhas(&blocos[t]);
+        else
+            pthread_join(ids[t], NULL);
+        sucesso = sucesso && blocos[t].sucesso;
+    }
+
+    free(blocos);
+    free(ids);
+    free(criada);
+
+    return sucesso;
+} // fim da função executa_por_linhas
+
+
+/* Retorna o instante atual, em segundos, de um relógio monotônico. */
+double instante_atual()
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+} // fim da função instante_atual
@@ -0,0 +1,19 @@
+#ifndef GRAFO_H_INCLUDED
+#define GRAFO_H_INCLUDED
+
+/* Número de bits de cada palavra de uma linha de bits de caixas empilháveis. */
+#define BITS_POR_PALAVRA 64
+
+/* Número de palavras necessárias para uma linha de bits com n caixas. */
+#define PALAVRAS_LINHA(n) (((n) + BITS_POR_PALAVRA - 1) / BITS_POR_PALAVRA)
+
+/* Tarefa executada sobre um bloco de linhas [inicio, fim). Retorna 0 (zero) em caso de falha. */
+typedef int (*tarefa_linhas)(int, int, void*);
+
+void marca_empilhaveis(const int*, const int*, int, int, int, unsigned long long*);
+
+int executa_por_linhas(int, tarefa_linhas, void*);
+
+double instante_atual();
+
+#endif // GRAFO_H_INCLUDED
@@ -0,0 +1,229 @@
+#include <stdlib.h>
+#include "janela.h"
+#include "grafo.h"
+#include "memoria.h"
+#include "perfil.h"
+
+/* Estratégia iterativa (bottom-up) com janela de valores e predecessores compactos, para alturas
+ * em que as duas matrizes da estratégia iterativa não cabem na memória, mas a de predecessores,
+ * compactada, ainda cabe.
+ *
+ * Como na estratégia em memória externa, os valores são mantidos em uma janela circular de A + 1
+ * linhas (A é a maior altura de caixa), e a solução ótima é o maior valor da linha h. A matriz de
+ * sequências de empilhamentos, entretanto, permanece na memória, com cada predecessor guardado no
+ * menor número de bytes que comporta os índices das caixas: 1 byte para até 255 caixas, 2 bytes
+ * para até 65535 e 4 bytes acima disso. O valor 0 (zero) indica a ausência de predecessor e os
+ * demais, o índice da caixa acrescido de 1.
+ *
+ * A memória utilizada é O(nA) inteiros para os valores e (h + 1)n predecessores compactos, isto
+ * é, de 1/8 a 1/2 da memória das duas matrizes da estratégia iterativa, sem acesso a disco.
+ */
+
+
+/* Retorna o número de bytes (1, 2 ou 4) de cada predecessor compacto, para um problema com n
+ * caixas.
+ *
+ * Complexidade: O(1)
+ */
+int largura_predecessor(int n)
+{
+    return (n <= 255) ? 1 : (n <= 65535) ? 2 : 4;
+} // fim da função largura_predecessor
+
+
+/* Grava, na posição pos da tabela de predecessores compactos de largura informada, o predecessor
+ * j (-1 se não houver).
+ *
+ * Complexidade: O(1)
+ */
+void grava_predecessor(unsigned char* tabela, int largura, long long pos, int j)
+{
+    switch (largura) {
+    case 1:
+        tabela[pos] = (unsigned char) (j + 1);
+        break;
+    case 2:
+        ((unsigned short*) tabela)[pos] = (unsigned short) (j + 1);
+        break;
+    default:
+        ((unsigned int*) tabela)[pos] = (unsigned int) (j + 1);
+    }
+} // fim da função grava_predecessor
+
+
+/* Retorna o predecessor gravado na posição pos da tabela de predecessores compactos de largura
+ * informada, ou -1 se não houver.
+ *
+ * Complexidade: O(1)
+ */
+int le_predecessor(const unsigned char* tabela, int largura, long long pos)
+{
+    switch (largura) {
+    case 1:
+        return (int) tabela[pos] - 1;
+    case 2:
+        return (int) ((const unsigned short*) tabela)[pos] - 1;
+    default:
+        return (int) ((const unsigned int*) tabela)[pos] - 1;
+    }
+} // fim da função le_predecessor
+
+
+/* Gera a pilha de caixas a partir da tabela de predecessores compactos, gravada linha a linha (a
+ * linha k começa na posição k * n). É o análogo da função reconstroi_pilha, e tem os mesmos
+ * parâmetros, exceto a tabela e a largura dos predecessores no lugar da matriz.
+ *
+ * Retorna o vetor com a pilha e o seu tamanho, ou NULL e o tamanho 0 (zero) em caso de falha na
+ * alocação de memória ou se a caixa da base for inválida.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n + h)
+ */
+int* reconstroi_pilha_compacta(const unsigned char* tabela, int largura, caixa* caixas, int n, int h, int base, int* tam)
+{
+    int *vetor, i, menor_altura, capacidade; // Vetor que será retornado pela função e variáveis auxiliares.
+
+    *tam = 0; // O tamanho da pilha é inicializado com 0 (zero).
+
+    if (base < 0 || base >= n || h < 0) // Verifica se o subproblema é válido.
+        return NULL;
+
+    // A menor altura de caixa limita o número de caixas de qualquer pilha de altura h.
+    menor_altura = caixas[0].a;
+    for(i = 1; i < n; i++)
+        if (caixas[i].a < menor_altura)
+            menor_altura = caixas[i].a;
+
+    capacidade = (menor_altura > 0) ? (h / menor_altura + 1) : (h + 1);
+
+    vetor = (int*) malloc(sizeof(int) * capacidade);
+
+    if (vetor) { // Verifica se a alocação foi bem sucedida.
+        while (base != -1 && h >= 0 && *tam < capacidade) {
+            vetor[(*tam)++] = base; // Insere a caixa na pilha.
+            i = le_predecessor(tabela, largura, (long long) h * n + base); // Caixa empilhada sobre ela.
+            h = h - caixas[base].a; // Desconta a altura da caixa inserida.
+            base = i;
+        }
+    }
+
+    return vetor; // Retorna o vetor criado ou NULL.
+} // fim da função reconstroi_pilha_compacta
+
+
+/* Encontra a solução ótima para o problema de empilhamento de caixas, utilizando a estratégia
+ * iterativa com janela de valores e predecessores compactos descrita no início do arquivo.
+ *
+ * Os parâmetros e os valores de retorno são os mesmos da função empilhamento_bottom_up.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n²h)
+ */
+int empilhamento_janela(problema p, int** vetor_de_caixas_empilhadas, int* tam)
+{
+    int *janela, *atual, *anterior; // Janela circular de valores e linhas em uso.
+    unsigned char *predecessores, *linha; // Tabela de predecessores compactos e linha em uso.
+    int k, i, j, h_aux, escolhida, num_linhas = 1, pos = 0, solucao_otima = -1; // Variáveis auxiliares.
+    int largura = largura_predecessor(p->n); // Bytes de cada predecessor.
+    lista *vetor_lista_de_caixas_empilhaveis; // Listas de caixas empilháveis.
+    tipo_nodo *no; // Variável auxiliar utilizada para percorrer a lista de caixas empilháveis.
+
+    // Verifica se a variável passada como parâmetro representa memória alocada.
+    if (*vetor_de_caixas_empilhadas)
+        free(*vetor_de_caixas_empilhadas); // Libera a memória alocada.
+
+    *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
+    *tam = 0;                           // referência e que retornarão valores também.
+
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
+    // A janela precisa de uma linha a mais do que a maior altura de caixa que cabe na pilha.
+    for(i = 0; i < p->n; i++)
+        if (p->caixas[i].a <= p->h && p->caixas[i].a + 1 > num_linhas)
+            num_linhas = p->caixas[i].a + 1;
+
+    janela = (int*) malloc(sizeof(int) * num_linhas * p->n);
+    predecessores = (unsigned char*) aloca_tabela((size_t) largura * (p->h + 1) * p->n, &p->est.tipo_paginas);
+    vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p);
+
+    if (janela && predecessores && vetor_lista_de_caixas_empilhaveis) {
+
+        // A linha 0 (zero) tem solução conhecida: valor 0 (zero) e nenhum empilhamento.
+        inicia_fase(p, FASE_PROGRAMACAO);
+        for(i = 0; i < p->n; i++) {
+            janela[i] = 0;
+            grava_predecessor(predecessores, largura, i, -1);
+        }
+
+        for(k = 1; k <= p->h; k++) {
+
+            atual = janela + (long long) (k % num_linhas) * p->n; // Linha k, na janela circular.
+            linha = predecessores + (long long) k * p->n * largura; // Predecessores da linha k.
+
+            for(i = 0; i < p->n; i++) {
+                atual[i] = 0;
+                escolhida = -1;
+
+                h_aux = k - p->caixas[i].a; // Subtrai a altura da caixa da altura k da iteração.
+
+                if (h_aux >= 0) { // Se o valor anterior for não-negativo, a caixa cabe na pilha.
+
+                    p->est.subproblemas++;
+                    p->est.transicoes += vetor_lista_de_caixas_empilhaveis[i]->tamanho;
+
+                    anterior = janela + (long long) (h_aux % num_linhas) * p->n; // Linha k - a(i).
+
+                    for(no = vetor_lista_de_caixas_empilhaveis[i]->first; no; no = no->next) {
+                        j = no->item.chave;
+                        if (p->v[i] + anterior[j] > atual[i]) {
+                            atual[i] = p->v[i] + anterior[j];
+                            if (anterior[j] != 0)   // O predecessor só é registrado se a caixa
+                                escolhida = j;      // for empilhada com outra(s).
+                        }
+                    }
+                }
+
+                grava_predecessor(linha, largura, i, escolhida);
+            }
+
+            // A cada INTERVALO_CONTROLE linhas, informa o progresso e verifica se houve pedido de cancelamento.
+            if ((k % INTERVALO_CONTROLE == 0 || k == p->h) && acompanha_resolucao(p, k, p->h))
+                break;
+        }
+
+        if (k <= p->h) { // Resolução interrompida: não há solução.
+            encerra_fase(p, FASE_PROGRAMACAO);
+            solucao_otima = RESOLUCAO_CANCELADA;
+        } else {
+            // A solução ótima é o maior valor da linha h (a menor caixa, em caso de empate).
+            atual = janela + (long long) (p->h % num_linhas) * p->n;
+            for(i = 1; i < p->n; i++)
+                if (atual[i] > atual[pos])
+                    pos = i;
+            solucao_otima = (p->n > 0) ? atual[pos] : 0;
+            encerra_fase(p, FASE_PROGRAMACAO);
+
+            if (solucao_otima > 0) { // Se a variável é maior do que 0 (zero), uma solução ótima foi encontrada.
+                inicia_fase(p, FASE_RECONSTRUCAO);
+                (*vetor_de_caixas_empilhadas) = reconstroi_pilha_compacta(predecessores, largura, p->caixas, p->n, p->h, pos, tam);
+                encerra_fase(p, FASE_RECONSTRUCAO);
+
+                if (!(*vetor_de_caixas_empilhadas)) // Verifica se a alocação foi bem sucedida.
+                    solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
+            }
+        }
+    }
+
+    // Libera todos os recursos alocados.
+    if (vetor_lista_de_caixas_empilhaveis)
+        termina_vetor_lista_de_caixas_empilhaveis(vetor_lista_de_caixas_empilhaveis, p->n);
+    libera_tabela(predecessores);
+    free(janela);
+
+    return solucao_otima; // Retorna a solução ótima ou -1, em caso de falha na alocação de memória.
+} // fim da função empilhamento_janela
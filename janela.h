@@ -0,0 +1,12 @@
+#ifndef JANELA_H_INCLUDED
+#define JANELA_H_INCLUDED
+
+#include "estruturas.h"
+
+int largura_predecessor(int);
+
+int* reconstroi_pilha_compacta(const unsigned char*, int, caixa*, int, int, int, int*);
+
+int empilhamento_janela(problema, int**, int*);
+
+#endif // JANELA_H_INCLUDED
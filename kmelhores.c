@@ -0,0 +1,271 @@
+#include <stdlib.h>
+#include <limits.h>
+#include "kmelhores.h"
+#include "memoria.h"
+
+/* Estratégia iterativa (bottom-up) que retorna as K melhores pilhas distintas em uma única
+ * resolução, em vez de apenas a ótima.
+ *
+ * Cada célula (k, i) da matriz guarda, em ordem decrescente de valor, as até K melhores pilhas de
+ * altura até k com a caixa i na base. Cada entrada registra o seu valor e o seu predecessor: a
+ * caixa j logo acima de i e a posição da entrada usada na lista da célula (k - a_i, j), ou -1 se
+ * a pilha é formada apenas pela caixa i. A lista de uma célula é a intercalação das listas das
+ * células (k - a_i, j), para as caixas j empilháveis sobre i, acrescidas de v_i, com a pilha
+ * formada apenas por i. Como as listas são decrescentes, apenas as listas com as K maiores cabeças
+ * podem contribuir: elas são selecionadas com um heap de mínimo de K posições (percorrendo o vetor
+ * contíguo com o melhor valor de cada célula) e intercaladas com um heap de máximo, até que K
+ * entradas sejam obtidas, ao custo de O(n + K log K) por célula.
+ *
+ * Cada pilha corresponde a exatamente um caminho de entradas a partir da linha h (a altura
+ * disponível em cada nível é determinada pelas caixas abaixo), de modo que as entradas distintas
+ * da linha h são pilhas distintas. As K melhores são obtidas por uma última intercalação dessa
+ * linha. A segunda rotação de uma caixa com largura igual à altura é idêntica à primeira e é
+ * ignorada, para que a mesma pilha física não seja listada duas vezes.
+ */
+
+#define SEM_PILHA INT_MIN // Melhor valor de uma célula sem pilhas.
+
+/* Entrada de uma célula: uma pilha, identificada pelo seu valor e pelo seu predecessor. Também é
+ * usada como elemento do heap de intercalação. */
+typedef struct {
+    int valor; // Valor da pilha.
+    int caixa; // Caixa logo acima da base (-1 se a pilha tem uma única caixa).
+    int ordem; // Posição da entrada usada na lista da célula da caixa acima.
+} entrada_k;
+
+
+/* Restaura a propriedade de heap de máximo (pelo valor) a partir da posição pos.
+ *
+ * Complexidade: O(log tam)
+ */
+void desce_heap_k(entrada_k* heap, int tam, int pos)
+{
+    entrada_k aux; // Variável auxiliar.
+    int filho; // Maior filho da posição atual.
+
+    for(filho = 2 * pos + 1; filho < tam; pos = filho, filho = 2 * pos + 1) {
+        if (filho + 1 < tam && heap[filho + 1].valor > heap[filho].valor)
+            filho++;
+        if (heap[pos].valor >= heap[filho].valor)
+            break;
+        aux = heap[pos];
+        heap[pos] = heap[filho];
+        heap[filho] = aux;
+    }
+} // fim da função desce_heap_k
+
+
+/* Restaura a propriedade de heap de máximo (pelo valor) a partir da posição pos, em direção à raiz.
+ *
+ * Complexidade: O(log pos)
+ */
+void sobe_heap_k(entrada_k* heap, int pos)
+{
+    entrada_k aux; // Variável auxiliar.
+
+    for(; pos > 0 && heap[(pos - 1) / 2].valor < heap[pos].valor; pos = (pos - 1) / 2) {
+        aux = heap[pos];
+        heap[pos] = heap[(pos - 1) / 2];
+        heap[(pos - 1) / 2] = aux;
+    }
+} // fim da função sobe_heap_k
+
+
+/* Indica se a caixa i é a segunda rotação, idêntica à primeira, de uma caixa com largura igual à
+ * altura (ver cria_problema_de_vetores). */
+int rotacao_repetida(problema p, int i)
+{
+    return (i % 2 == 1 && p->caixas[i].l == p->caixas[i - 1].l && p->caixas[i].a == p->caixas[i - 1].a &&
+            p->caixas[i].p == p->caixas[i - 1].p && p->v[i] == p->v[i - 1]);
+} // fim da função rotacao_repetida
+
+
+/* Encontra as K melhores pilhas distintas para o problema de empilhamento de caixas, utilizando a
+ * estratégia descrita no início do arquivo. Os parâmetros de entrada são:
+ *
+ *      - o problema p;
+ *      - o número K de pilhas desejadas;
+ *      - um vetor de K ponteiros, que receberão os vetores com os índices das caixas de cada pilha
+ *        (da base para o topo), da melhor para a pior;
+ *      - um vetor de K inteiros, que receberão os tamanhos das pilhas;
+ *      - um vetor de K inteiros, que receberão os valores das pilhas.
+ *
+ * Apenas pilhas de valor positivo são retornadas. Retorna o número de pilhas encontradas (no máximo
+ * K) ou -1, em caso de falha na alocação de memória.
+ *
+ * Obs.: A função cria vetores alocados dinamicamente. É responsabilidade do utilizador desta função
+ * desalocá-los posteriormente.
+ *
+ * Complexidade: O(nh(n + K log K)) de tempo e O(nhK) de memória.
+ */
+int empilhamento_k_melhores(problema p, int K, int** pilhas, int* tamanhos, int* valores)
+{
+    entrada_k *tabela, *heap, *selecao, *e; // Entradas das células e heaps de intercalação e de seleção.
+    int *quantidade, *melhor; // Número de entradas e melhor valor de cada célula.
+    lista *vetor_lista_de_caixas_empilhaveis = NULL; // Listas de caixas empilháveis.
+    tipo_nodo *no; // Variável auxiliar utilizada para percorrer as listas.
+    long long c, origem; // Células da matriz.
+    int i, j, k, t, tam_heap, tam_selecao, valor, encontradas = 0, falha = 0; // Variáveis auxiliares.
+
+    for(t = 0; t < K; t++) { // Inicialização das variáveis passadas por referência.
+        pilhas[t] = NULL;
+        tamanhos[t] = 0;
+        valores[t] = 0;
+    }
+
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
+    if (K <= 0)
+        return 0;
+
+    tabela = (entrada_k*) aloca_tabela(sizeof(entrada_k) * (p->h + 1) * p->n * K, &p->est.tipo_paginas);
+    quantidade = (int*) aloca_tabela(sizeof(int) * (p->h + 1) * p->n, NULL);
+    melhor = (int*) aloca_tabela(sizeof(int) * (p->h + 1) * p->n, NULL);
+    heap = (entrada_k*) malloc(sizeof(entrada_k) * ((p->n > K) ? p->n + 1 : K + 1));
+    selecao = (entrada_k*) malloc(sizeof(entrada_k) * K);
+    if (tabela && quantidade && melhor && heap && selecao)
+        vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p);
+
+    if (!vetor_lista_de_caixas_empilhaveis) {
+        libera_tabela(tabela);
+        libera_tabela(quantidade);
+        libera_tabela(melhor);
+        free(heap);
+        free(selecao);
+        return -1; // Falha, devido à ausência de recursos computacionais.
+    }
+
+    for(i = 0; i < p->n; i++) { // A linha 0 (zero) não tem pilhas.
+        quantidade[i] = 0;
+        melhor[i] = SEM_PILHA;
+    }
+
+    for(k = 1; k <= p->h; k++) {
+        for(i = 0; i < p->n; i++) {
+            c = (long long) k * p->n + i;
+            quantidade[c] = 0;
+            melhor[c] = SEM_PILHA;
+
+            if (p->caixas[i].a <= 0 || p->caixas[i].a > k || rotacao_repetida(p, i))
+                continue; // A caixa não cabe (ou repete a rotação anterior).
+
+            p->est.subproblemas++;
+            p->est.transicoes += vetor_lista_de_caixas_empilhaveis[i]->tamanho;
+
+            // Seleção das K maiores cabeças das listas das células (k - a_i, j). O heap de seleção
+            // guarda os valores com o sinal trocado, para que a raiz seja a menor cabeça selecionada.
+            origem = (long long) (k - p->caixas[i].a) * p->n;
+            tam_selecao = 0;
+            for(no = vetor_lista_de_caixas_empilhaveis[i]->first; no; no = no->next) {
+                j = no->item.chave;
+                if (melhor[origem + j] == SEM_PILHA)
+                    continue;
+                valor = p->v[i] + melhor[origem + j];
+                if (tam_selecao < K) {
+                    selecao[tam_selecao].valor = -valor;
+                    selecao[tam_selecao].caixa = j;
+                    selecao[tam_selecao].ordem = 0;
+                    sobe_heap_k(selecao, tam_selecao++);
+                } else if (-valor < selecao[0].valor) { // Supera a menor cabeça selecionada.
+                    selecao[0].valor = -valor;
+                    selecao[0].caixa = j;
+                    desce_heap_k(selecao, K, 0);
+                }
+            }
+
+            // Heap de intercalação: as cabeças selecionadas e a pilha formada apenas pela caixa i.
+            for(tam_heap = 0; tam_heap < tam_selecao; tam_heap++) {
+                heap[tam_heap] = selecao[tam_heap];
+                heap[tam_heap].valor = -heap[tam_heap].valor;
+            }
+            heap[tam_heap].valor = p->v[i];
+            heap[tam_heap].caixa = -1;
+            heap[tam_heap++].ordem = -1;
+            for(t = tam_heap / 2 - 1; t >= 0; t--)
+                desce_heap_k(heap, tam_heap, t);
+
+            // Retira as K maiores cabeças; cada retirada é substituída pela entrada seguinte da sua lista.
+            e = tabela + c * K;
+            while (tam_heap > 0 && quantidade[c] < K) {
+                e[quantidade[c]++] = heap[0];
+                j = heap[0].caixa;
+                if (j >= 0 && heap[0].ordem + 1 < quantidade[origem + j]) {
+                    heap[0].ordem++;
+                    heap[0].valor = p->v[i] + tabela[(origem + j) * K + heap[0].ordem].valor;
+                } else
+                    heap[0] = heap[--tam_heap];
+                desce_heap_k(heap, tam_heap, 0);
+            }
+            melhor[c] = e[0].valor;
+        }
+    }
+
+    termina_vetor_lista_de_caixas_empilhaveis(vetor_lista_de_caixas_empilhaveis, p->n);
+
+    // Intercalação final das listas da linha h, cujas entradas são as pilhas distintas.
+    origem = (long long) p->h * p->n;
+    tam_heap = 0;
+    for(i = 0; i < p->n; i++)
+        if (quantidade[origem + i] > 0) {
+            heap[tam_heap].valor = tabela[(origem + i) * K].valor;
+            heap[tam_heap].caixa = i;
+            heap[tam_heap++].ordem = 0;
+        }
+    for(t = tam_heap / 2 - 1; t >= 0; t--)
+        desce_heap_k(heap, tam_heap, t);
+
+    while (tam_heap > 0 && encontradas < K && heap[0].valor > 0 && !falha) {
+        // Reconstrução da pilha, seguindo os predecessores a partir da célula (h, caixa): a primeira
+        // passagem conta as caixas e a segunda as grava.
+        for(j = 0; j < 2; j++) {
+            if (j == 1) {
+                pilhas[encontradas] = (int*) malloc(sizeof(int) * tamanhos[encontradas]);
+                if (!pilhas[encontradas]) {
+                    falha = 1;
+                    break;
+                }
+                tamanhos[encontradas] = 0;
+            }
+
+            for(k = p->h, i = heap[0].caixa, t = heap[0].ordem; i >= 0; ) {
+                if (j == 1)
+                    pilhas[encontradas][tamanhos[encontradas]] = i;
+                tamanhos[encontradas]++;
+                e = tabela + ((long long) k * p->n + i) * K + t;
+                k -= p->caixas[i].a;
+                i = e->caixa;
+                t = e->ordem;
+            }
+        }
+        if (falha)
+            break;
+        valores[encontradas++] = heap[0].valor;
+
+        i = heap[0].caixa;
+        if (heap[0].ordem + 1 < quantidade[origem + i]) {
+            heap[0].ordem++;
+            heap[0].valor = tabela[(origem + i) * K + heap[0].ordem].valor;
+        } else
+            heap[0] = heap[--tam_heap];
+        desce_heap_k(heap, tam_heap, 0);
+    }
+
+    libera_tabela(tabela);
+    libera_tabela(quantidade);
+    libera_tabela(melhor);
+    free(heap);
+    free(selecao);
+
+    if (falha) { // Desfaz as pilhas já reconstruídas.
+        for(t = 0; t < K; t++) {
+            free(pilhas[t]);
+            pilhas[t] = NULL;
+            tamanhos[t] = 0;
+            valores[t] = 0;
+        }
+        return -1; // Falha, devido à ausência de recursos computacionais.
+    }
+
+    return encontradas; // Retorna o número de pilhas encontradas.
+} // fim da função empilhamento_k_melhores
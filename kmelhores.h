@@ -0,0 +1,8 @@
+#ifndef KMELHORES_H_INCLUDED
+#define KMELHORES_H_INCLUDED
+
+#include "estruturas.h"
+
+int empilhamento_k_melhores(problema, int, int**, int*, int*);
+
+#endif // KMELHORES_H_INCLUDED
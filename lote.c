@@ -0,0 +1,441 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "lote.h"
+#include "funcoes.h"
+
+/* Processamento em lote: qualquer número de processos, em uma ou mais máquinas que compartilham o
+ * sistema de arquivos, resolve as instâncias de um mesmo diretório, sem coordenação externa.
+ *
+ * O estado de cada instância é dado apenas pelo nome do seu arquivo no diretório do lote:
+ *
+ *      - "x.data": pendente;
+ *      - "x.data.<processo>.reserva": reservada pelo processo (máquina e pid) que a renomeou;
+ *      - "x.data.concluido": resolvida, com a solução em "x.sol";
+ *      - "x.data.falha": não pôde ser lida ou resolvida.
+ *
+ * A reserva é feita por uma renomeação, que é atômica: se vários processos tentam reservar a mesma
+ * instância, apenas um consegue, e os demais procuram outra. Enquanto resolve a instância, o
+ * processo renova periodicamente a reserva (uma thread atualiza as datas do arquivo). A data de
+ * alteração do arquivo (ctime), atualizada pela renomeação e pelas renovações, marca o último
+ * sinal de vida: uma reserva sem renovação há mais do que o prazo de concessão é de um processo
+ * parado e é devolvida ao lote (renomeada de volta para "x.data") pelo primeiro processo que a
+ * encontrar. As máquinas devem, portanto, ter os relógios sincronizados.
+ *
+ * A solução é gravada em um arquivo auxiliar e então renomeada para "x.sol", de modo que nenhum
+ * leitor encontra soluções incompletas (uma instância devolvida ao lote e resolvida duas vezes
+ * produz a mesma solução). Cada resolução acrescenta ao registro de tempos (REGISTRO_LOTE) uma
+ * linha "<instância> <processo> <estratégia> <valor> <segundos> <início>", com o início em segundos
+ * desde 1970, gravada com uma única escrita em modo de acréscimo (O_APPEND), que não se mistura às
+ * dos demais processos.
+ *
+ * Os processos não disputam nada além das renomeações, e cada um começa a procura das instâncias
+ * pendentes em uma posição diferente da listagem do diretório, de modo que a vazão cresce
+ * linearmente com o número de processos, até o limite de instâncias ou de processadores.
+ */
+
+#define EXTENSAO_LOTE ".data" // Extensão das instâncias pendentes.
+#define SUFIXO_RESERVA ".reserva" // Sufixo das instâncias reservadas.
+
+/* Renovação periódica da reserva de uma instância, executada por uma thread durante a resolução. */
+typedef struct {
+    const char* caminho; // Arquivo da reserva.
+    double intervalo; // Intervalo entre as renovações, em segundos.
+    int parar; // Diferente de zero quando a resolução terminou.
+    pthread_mutex_t trava; // Trava do campo parar.
+    pthread_cond_t sinal; // Sinalizado quando a resolução termina.
+} renovacao_reserva;
+
+
+/* Retorna o caminho formado pelo diretório, pelo nome e pelo sufixo informados.
+ *
+ * Obs.: A função cria e retorna uma cadeia alocada dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-la posteriormente.
+ *
+ * Complexidade: O(tamanho do caminho)
+ */
+char* caminho_lote(const char* diretorio, const char* nome, const char* sufixo)
+{
+    char* caminho = (char*) malloc(strlen(diretorio) + strlen(nome) + strlen(sufixo) + 2);
+
+    if (caminho)
+        sprintf(caminho, "%s/%s%s", diretorio, nome, sufixo);
+    return caminho;
+} // fim da função caminho_lote
+
+
+/* Indica se o nome termina com o sufixo informado.
+ *
+ * Complexidade: O(tamanho do sufixo)
+ */
+int termina_com(const char* nome, const char* sufixo)
+{
+    size_t n = strlen(nome), s = strlen(sufixo); // Tamanhos.
+
+    return n > s && strcmp(nome + n - s, sufixo) == 0;
+} // fim da função termina_com
+
+
+/* Grava em id a identificação deste processo nas reservas: o nome da máquina (com os pontos
+ * trocados por sublinhados, para que o nome da reserva tenha um formato fixo) e o pid.
+ *
+ * Complexidade: O(tam)
+ */
+void identifica_processo(char* id, size_t tam)
+{
+    char maquina[128]; // Nome da máquina.
+    int i; // Variável auxiliar.
+
+    if (gethostname(maquina, sizeof(maquina)) != 0)
+        strcpy(maquina, "local");
+    maquina[sizeof(maquina) - 1] = '\0';
+
+    for(i = 0; maquina[i]; i++)
+        if (maquina[i] == '.' || maquina[i] == '/')
+            maquina[i] = '_';
+
+    snprintf(id, tam, "%s-%ld", maquina, (long) getpid());
+} // fim da função identifica_processo
+
+
+/* Percorre as reservas do diretório do lote, devolvendo ao lote (renomeadas de volta para
+ * "x.data") as que não foram renovadas há mais do que concessao segundos. O número de reservas
+ * ainda válidas é gravado em ativas.
+ *
+ * Retorna o número de reservas devolvidas, ou -1 se o diretório não pôde ser lido.
+ *
+ * Complexidade: O(m), em que m é o número de arquivos do diretório.
+ */
+int recupera_reservas(const char* diretorio, double concessao, int* ativas)
+{
+    DIR* dir; // Diretório do lote.
+    struct dirent* entrada; // Entrada do diretório.
+    struct stat info; // Atributos de uma reserva.
+    struct timespec agora; // Instante atual.
+    char *reserva, *original, *ponto; // Caminhos da reserva e da instância pendente.
+    int recuperadas = 0; // Variável auxiliar.
+
+    *ativas = 0;
+
+    dir = opendir(diretorio);
+    if (!dir)
+        return -1;
+
+    clock_gettime(CLOCK_REALTIME, &agora);
+
+    while ((entrada = readdir(dir)) != NULL) {
+        if (!termina_com(entrada->d_name, SUFIXO_RESERVA))
+            continue;
+
+        reserva = caminho_lote(diretorio, entrada->d_name, "");
+        original = caminho_lote(diretorio, entrada->d_name, "");
+
+        if (reserva && original && stat(reserva, &info) == 0) {
+            if (agora.tv_sec + agora.tv_nsec / 1e9 - (info.st_ctim.tv_sec + info.st_ctim.tv_nsec / 1e9) > concessao) {
+                // Remove ".<processo>.reserva" do nome, o que restaura "x.data".
+                original[strlen(original) - strlen(SUFIXO_RESERVA)] = '\0';
+                ponto = strrchr(original, '.');
+                if (ponto)
+                    *ponto = '\0';
+
+                if (rename(reserva, original) == 0) // Outro processo pode tê-la devolvido antes.
+                    recuperadas++;
+            } else
+                (*ativas)++;
+        }
+
+        free(reserva);
+        free(original);
+    }
+
+    closedir(dir);
+    return recuperadas;
+} // fim da função recupera_reservas
+
+
+/* Reserva uma instância pendente do diretório do lote para o processo id, renomeando-a. A procura
+ * começa em uma posição da listagem que depende de inicio, para que processos diferentes tentem,
+ * em geral, instâncias diferentes. Os nomes da instância (sem a extensão) e da reserva são gravados
+ * em nome e em reserva.
+ *
+ * Retorna 1 (um) se uma instância foi reservada, 0 (zero) se não há instâncias pendentes ou -1 se o
+ * diretório não pôde ser lido ou em caso de falha na alocação de memória.
+ *
+ * Obs.: A função cria cadeias alocadas dinamicamente. É responsabilidade do utilizador desta
+ * função desalocá-las posteriormente.
+ *
+ * Complexidade: O(m), em que m é o número de arquivos do diretório.
+ */
+int reserva_instancia(const char* diretorio, const char* id, unsigned int inicio, char** nome, char** reserva)
+{
+    DIR* dir; // Diretório do lote.
+    struct dirent* entrada; // Entrada do diretório.
+    char **pendentes = NULL, **novo, *original, *sufixo; // Instâncias pendentes e caminhos.
+    int num_pendentes = 0, capacidade = 0, t, i, resultado = 0; // Variáveis auxiliares.
+
+    *nome = *reserva = NULL;
+
+    dir = opendir(diretorio);
+    if (!dir)
+        return -1;
+
+    while ((entrada = readdir(dir)) != NULL && resultado == 0) {
+        if (!termina_com(entrada->d_name, EXTENSAO_LOTE))
+            continue;
+
+        if (num_pendentes == capacidade) {
+            capacidade = (capacidade > 0) ? 2 * capacidade : 64;
+            novo = (char**) realloc(pendentes, sizeof(char*) * capacidade);
+            if (!novo)
+                resultado = -1;
+            else
+                pendentes = novo;
+        }
+
+        if (resultado == 0 && (pendentes[num_pendentes] = strdup(entrada->d_name)) != NULL)
+            num_pendentes++;
+        else
+            resultado = -1;
+    }
+    closedir(dir);
+
+    // Tenta renomear as instâncias pendentes, a partir da posição inicial, até conseguir uma.
+    for(t = 0; t < num_pendentes && resultado == 0; t++) {
+        i = (int) ((inicio + (unsigned int) t) % (unsigned int) num_pendentes);
+
+        sufixo = (char*) malloc(strlen(id) + strlen(SUFIXO_RESERVA) + 2);
+        original = caminho_lote(diretorio, pendentes[i], "");
+        if (sufixo)
+            sprintf(sufixo, ".%s%s", id, SUFIXO_RESERVA);
+        *reserva = sufixo ? caminho_lote(diretorio, pendentes[i], sufixo) : NULL;
+
+        if (!original || !*reserva)
+            resultado = -1;
+        else if (rename(original, *reserva) == 0) { // Outro processo pode tê-la reservado antes.
+            pendentes[i][strlen(pendentes[i]) - strlen(EXTENSAO_LOTE)] = '\0';
+            *nome = pendentes[i];
+            pendentes[i] = NULL;
+            resultado = 1;
+        }
+
+        free(sufixo);
+        free(original);
+        if (resultado != 1) {
+            free(*reserva);
+            *reserva = NULL;
+        }
+    }
+
+    for(t = 0; t < num_pendentes; t++)
+        free(pendentes[t]);
+    free(pendentes);
+
+    return resultado;
+} // fim da função reserva_instancia
+
+
+/* Função de entrada da thread que renova a reserva de uma instância enquanto ela é resolvida. */
+void* executa_renovacao(void* arg)
+{
+    renovacao_reserva* r = (renovacao_reserva*) arg; // Reserva a renovar.
+    struct timespec limite; // Instante da próxima renovação.
+
+    pthread_mutex_lock(&r->trava);
+    while (!r->parar) {
+        clock_gettime(CLOCK_REALTIME, &limite);
+        limite.tv_sec += (time_t) r->intervalo;
+        limite.tv_nsec += (long) ((r->intervalo - (time_t) r->intervalo) * 1e9);
+        if (limite.tv_nsec >= 1000000000L) {
+            limite.tv_sec++;
+            limite.tv_nsec -= 1000000000L;
+        }
+
+        if (pthread_cond_timedwait(&r->sinal, &r->trava, &limite) == ETIMEDOUT && !r->parar)
+            utimensat(AT_FDCWD, r->caminho, NULL, 0); // Atualiza as datas (e a de alteração) da reserva.
+    }
+    pthread_mutex_unlock(&r->trava);
+
+    return NULL;
+} // fim da função executa_renovacao
+
+
+/* Acrescenta ao registro de tempos do diretório do lote a linha de uma resolução, com uma única
+ * escrita em modo de acréscimo.
+ *
+ * Retorna 1 (um) se a linha foi gravada, ou 0 (zero) caso contrário.
+ *
+ * Complexidade: O(1)
+ */
+int registra_tempo_lote(const char* diretorio, const char* nome, const char* id, int motor, int valor,
+                        double segundos, double inicio)
+{
+    char linha[1024], *caminho; // Linha do registro e caminho do arquivo.
+    int fd, tam, sucesso = 0; // Variáveis auxiliares.
+
+    tam = snprintf(linha, sizeof(linha), "%s %s %s %d %.6f %.3f\n", nome, id, nome_motor(motor), valor, segundos, inicio);
+    caminho = caminho_lote(diretorio, REGISTRO_LOTE, "");
+
+    if (caminho && tam > 0 && tam < (int) sizeof(linha)) {
+        fd = open(caminho, O_WRONLY | O_APPEND | O_CREAT, 0666);
+        if (fd >= 0) {
+            sucesso = (write(fd, linha, tam) == tam);
+            close(fd);
+        }
+    }
+
+    free(caminho);
+    return sucesso;
+} // fim da função registra_tempo_lote
+
+
+/* Grava a solução da instância de nome informado em "<nome>.sol", no diretório do lote, por meio
+ * de um arquivo auxiliar exclusivo do processo id, renomeado ao final.
+ *
+ * Retorna 1 (um) se a solução foi gravada, ou 0 (zero) caso contrário.
+ *
+ * Complexidade: O(tam)
+ */
+int publica_solucao_lote(const char* diretorio, const char* nome, const char* id, const solucao_empilhamento* s)
+{
+    char *auxiliar, *final, *sufixo; // Caminhos dos arquivos.
+    int sucesso = 0; // Variável auxiliar.
+
+    sufixo = (char*) malloc(strlen(id) + 16);
+    if (sufixo)
+        sprintf(sufixo, ".sol.%s.tmp", id);
+    auxiliar = sufixo ? caminho_lote(diretorio, nome, sufixo) : NULL;
+    final = caminho_lote(diretorio, nome, ".sol");
+
+    if (auxiliar && final) {
+        sucesso = gera_arquivo_saida(auxiliar, s->valor, s->caixas, s->tam) && rename(auxiliar, final) == 0;
+        if (!sucesso)
+            remove(auxiliar);
+    }
+
+    free(sufixo);
+    free(auxiliar);
+    free(final);
+    return sucesso;
+} // fim da função publica_solucao_lote
+
+
+/* Resolve, com as opções informadas, as instâncias pendentes do diretório do lote, em cooperação
+ * com os demais processos que processam o mesmo diretório (ver o início do arquivo). Reservas sem
+ * renovação há mais de concessao segundos (CONCESSAO_PADRAO, se concessao não for positivo) são
+ * devolvidas ao lote. O processo termina quando não há instâncias pendentes nem reservadas; enquanto
+ * houver reservas de outros processos, ele aguarda, para recuperá-las se os processos pararem.
+ *
+ * Os totais deste processo são gravados em resumo.
+ *
+ * Retorna o número de instâncias resolvidas, ou -1 se o diretório não pôde ser lido ou em caso de
+ * falha na alocação de memória.
+ *
+ * Complexidade: a das resoluções, mais O(m) por instância, em que m é o número de arquivos do diretório.
+ */
+int processa_lote(const char* diretorio, const opcoes_empilhamento* opcoes, double concessao, resumo_lote* resumo)
+{
+    char id[192], *nome, *reserva, *destino; // Identificação do processo, instância e caminhos.
+    renovacao_reserva renovacao; // Renovação da reserva durante a resolução.
+    pthread_t thread; // Thread de renovação.
+    struct timespec inicio, fim, espera, relogio; // Instantes e intervalo de espera.
+    solucao_empilhamento s; // Solução da instância.
+    problema p; // Instância reservada.
+    unsigned int posicao; // Posição inicial da procura de instâncias pendentes.
+    int ativas, r, renovando; // Variáveis auxiliares.
+
+    resumo->resolvidas = resumo->falhas = resumo->recuperadas = 0;
+    resumo->segundos = 0;
+
+    if (concessao <= 0)
+        concessao = CONCESSAO_PADRAO;
+
+    identifica_processo(id, sizeof(id));
+    posicao = (unsigned int) getpid() * 2654435761u;
+
+    // Sem instâncias pendentes, aguarda um quarto da concessão (no máximo um segundo) pelas reservas alheias.
+    espera.tv_sec = (concessao >= 4) ? 1 : 0;
+    espera.tv_nsec = (concessao >= 4) ? 0 : (long) (concessao / 4 * 1e9);
+
+    for(;;) {
+        r = recupera_reservas(diretorio, concessao, &ativas);
+        if (r < 0)
+            return -1;
+        resumo->recuperadas += r;
+
+        r = reserva_instancia(diretorio, id, posicao++, &nome, &reserva);
+        if (r < 0)
+            return -1;
+
+        if (r == 0) { // Nenhuma instância pendente.
+            if (ativas == 0)
+                break; // O lote terminou.
+            nanosleep(&espera, NULL);
+            continue;
+        }
+
+        // Renova a reserva a cada quarto da concessão, enquanto a instância é resolvida.
+        renovacao.caminho = reserva;
+        renovacao.intervalo = concessao / 4;
+        renovacao.parar = 0;
+        pthread_mutex_init(&renovacao.trava, NULL);
+        pthread_cond_init(&renovacao.sinal, NULL);
+        renovando = (pthread_create(&thread, NULL, executa_renovacao, &renovacao) == 0);
+
+        clock_gettime(CLOCK_REALTIME, &relogio);
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+
+        s.valor = -1;
+        s.caixas = NULL;
+        p = processa_arquivo_entrada(reserva);
+        if (p) {
+            resolve_empilhamento(p, opcoes, &s);
+            termina_problema(p);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &fim);
+
+        if (renovando) {
+            pthread_mutex_lock(&renovacao.trava);
+            renovacao.parar = 1;
+            pthread_cond_signal(&renovacao.sinal);
+            pthread_mutex_unlock(&renovacao.trava);
+            pthread_join(thread, NULL);
+        }
+        pthread_mutex_destroy(&renovacao.trava);
+        pthread_cond_destroy(&renovacao.sinal);
+
+        // Publica a solução e retira a instância do lote (se ela não foi devolvida entretanto).
+        if (s.valor >= 0 && publica_solucao_lote(diretorio, nome, id, &s)) {
+            destino = caminho_lote(diretorio, nome, EXTENSAO_LOTE ".concluido");
+            resumo->resolvidas++;
+        } else {
+            destino = caminho_lote(diretorio, nome, EXTENSAO_LOTE ".falha");
+            resumo->falhas++;
+        }
+        if (destino)
+            rename(reserva, destino);
+
+        resumo->segundos += (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+        registra_tempo_lote(diretorio, nome, id, opcoes ? opcoes->motor : MOTOR_BOTTOM_UP, s.valor,
+                            (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9,
+                            relogio.tv_sec + relogio.tv_nsec / 1e9);
+
+        if (s.valor >= 0)
+            termina_solucao(&s);
+        free(destino);
+        free(nome);
+        free(reserva);
+    }
+
+    return resumo->resolvidas;
+} // fim da função processa_lote
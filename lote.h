@@ -0,0 +1,21 @@
+#ifndef LOTE_H_INCLUDED
+#define LOTE_H_INCLUDED
+
+#include "empilhamento.h"
+
+/* Prazo padrão de uma reserva, em segundos, sem sinal de vida do processo que a detém. */
+#define CONCESSAO_PADRAO 60.0
+
+/* Nome do registro de tempos, no diretório do lote. */
+#define REGISTRO_LOTE "tempos.log"
+
+typedef struct {
+    int resolvidas; // Instâncias resolvidas por este processo.
+    int falhas; // Instâncias que não puderam ser lidas ou resolvidas.
+    int recuperadas; // Reservas vencidas (de processos parados) devolvidas ao lote.
+    double segundos; // Tempo total de resolução, em segundos.
+} resumo_lote;
+
+int processa_lote(const char*, const opcoes_empilhamento*, double, resumo_lote*);
+
+#endif // LOTE_H_INCLUDED
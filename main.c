@@ -21,15 +21,101 @@
 #include <string.h>
 #include <time.h>
 #include "funcoes.h"
+#include "empilhamento.h"
+#include "memoria.h"
+#include "planejador.h"
+#include "cache.h"
+#include "lote.h"
+#include "perfil.h"
 
 /* Função principal do programa. Os parâmetros de execução (localização e nomes dos arquivos
  * de entrada e de saída) devem ser passados via linha de comando, com a seguinte sintaxe:
  *
- * nome_executavel [-r|-R] <arquivo_entrada> <arquivo_saida>
+ * nome_executavel [-r|-R] [-b|-B] [-p|-P] [-t|-T <threads>] [-x|-X] [-w|-W] [-u|-U] [-d|-D] [-s|-S]
+ *                 [-e|-E] [--perf] [--checkpoint <arquivo> [--resume] [--checkpoint-overhead <porcentagem>]]
+ *                 [--deadline <milissegundos>] [--epsilon <erro>] [--top <k>] [--mem-limit <MB>]
+ *                 [--cache <diretorio> [--cache-size <MB>]]
+ *                 <arquivo_entrada> <arquivo_saida>
+ *
+ * nome_executavel [opções de estratégia] --spool <diretorio> [--lease <segundos>]
  *
  * O parâmetro -r (ou -R) indica que se deseja realizar a solução do problema de empilhamento
- * através de uma função recursiva (top-down). Se o parâmetro -r (ou -R) é omitido, a solução
- * do problema se dará por uma função iterativa (bottom-up).
+ * através de uma função recursiva (top-down). O parâmetro -b (ou -B) indica que se deseja a
+ * função recursiva com poda do tipo branch and bound. O parâmetro -p (ou -P) indica a função
+ * iterativa que detecta o regime periódico das soluções, própria para alturas muito grandes.
+ * O parâmetro -t (ou -T) indica a função recursiva paralela, com o número de threads informado
+ * a seguir (0 usa uma thread por processador). O parâmetro -x (ou -X) indica a função iterativa em
+ * memória externa, que grava as sequências de empilhamentos em um arquivo temporário e mantém em
+ * memória apenas as últimas linhas da matriz de soluções, para alturas que excedem a memória.
+ * O parâmetro -w (ou -W) indica a função iterativa que também mantém apenas as últimas linhas da
+ * matriz de soluções, mas guarda as sequências de empilhamentos em memória, com 1, 2 ou 4 bytes
+ * por posição. O parâmetro -u (ou -U) indica a função iterativa indexada pelo valor acumulado, que
+ * calcula a menor altura de cada valor e é própria para alturas muito grandes com valores pequenos.
+ * O parâmetro -d (ou -D) indica a função que guarda, para cada caixa da base, apenas as alturas em
+ * que o valor da melhor pilha muda (degraus), própria para instâncias com poucas alturas de pilha
+ * distintas.
+ *
+ * O parâmetro --checkpoint também seleciona a função em memória externa e faz com que ela grave,
+ * periodicamente, pontos de verificação no arquivo informado (e as sequências de empilhamentos no
+ * mesmo arquivo, acrescido de ".indices"). Com --resume, uma resolução interrompida continua a partir
+ * do último ponto de verificação. O parâmetro --checkpoint-overhead limita o tempo gasto com os pontos
+ * de verificação a uma porcentagem do tempo de resolução (padrão: 1%).
+ *
+ * O parâmetro --deadline indica a função anytime, que retorna a melhor pilha encontrada dentro do
+ * prazo informado (em milissegundos), e exibe um limitante superior para o valor ótimo e a distância
+ * relativa (gap) entre ele e o valor da pilha.
+ *
+ * O parâmetro --epsilon indica a função aproximada, que resolve o problema com as alturas medidas
+ * em uma escala reduzida (o erro relativo de cada altura não excede o valor informado, por exemplo
+ * 0.01), e exibe um limitante superior para o valor ótimo e a razão mínima entre o valor obtido e
+ * o ótimo.
+ *
+ * O parâmetro --top indica a função que obtém, em uma única resolução, as k melhores pilhas
+ * distintas. A melhor é gravada no arquivo de saída e as demais em arquivos de mesmo nome,
+ * acrescidos de ".2", ".3", etc., no mesmo formato.
+ *
+ * O parâmetro --mem-limit delega a escolha da estratégia ao planejador de memória, que estima, antes
+ * de qualquer alocação, a memória e o tempo da tabela completa (iterativa), da janela com
+ * predecessores compactos (-w), da memória externa (-x) e da tabela indexada pelo valor (-u), e
+ * escolhe a mais rápida que cabe no limite informado (em megabytes). As estimativas e a escolha são
+ * exibidas.
+ *
+ * O parâmetro --cache indica o diretório de um cache de soluções: instâncias iguais a menos da ordem
+ * das caixas são resolvidas uma única vez, e as repetições usam a pilha gravada, convertida para a
+ * numeração de caixas da nova instância. O parâmetro --cache-size limita o tamanho do diretório
+ * (padrão: 64 MB); as entradas usadas há mais tempo são removidas.
+ *
+ * O parâmetro --spool substitui os arquivos de entrada e de saída pelo diretório de um lote (ver
+ * lote.c): o processo reserva, uma a uma, as instâncias .data pendentes do diretório, resolve-as
+ * com a estratégia escolhida e grava as soluções .sol no mesmo diretório, em cooperação com os
+ * demais processos (em qualquer máquina) que processam o lote. O parâmetro --lease define o prazo,
+ * em segundos, após o qual a reserva de um processo que parou de renová-la é devolvida ao lote
+ * (padrão: 60). Os parâmetros --top, --mem-limit e --cache não se aplicam, e --checkpoint e --resume
+ * são recusados: os processos do lote gravariam os mesmos arquivos de pontos de verificação.
+ * Se todos são omitidos, a solução do problema se dará por uma função iterativa (bottom-up): a
+ * indexada pelo valor, se o limitante para o valor da pilha é menor do que a altura máxima, ou a
+ * indexada pela altura, caso contrário.
+ *
+ * Antes da resolução, as caixas que nunca fazem parte de uma solução ótima (rotações idênticas,
+ * dominadas ou que não cabem na pilha) são eliminadas. O parâmetro -s (ou -S) desabilita essa
+ * redução, sem alterar o resultado.
+ *
+ * O parâmetro -e (ou -E) exibe, ao final da execução, o número de subproblemas avaliados e de
+ * empilhamentos examinados pela função utilizada, o que permite comparar o esforço das estratégias,
+ * o tempo gasto na construção da relação de empilhamento entre as caixas, que faz parte do
+ * tempo de execução, o tipo de página das tabelas e, quando o sistema permite a leitura dos
+ * contadores de hardware, as falhas de TLB e a fração de acessos a outro nó NUMA (exceto com --perf
+ * ou --top, em que esses contadores não são abertos).
+ *
+ * O parâmetro --perf mede, com os contadores de hardware do processador (ver perfil.c), as fases da
+ * resolução nas estratégias iterativas: construção da relação de empilhamento, laço da programação
+ * dinâmica e reconstrução da pilha. Para cada fase são exibidos o tempo, os ciclos, as instruções,
+ * as instruções por ciclo (IPC) e as falhas de cache L1 e de último nível, de previsão de desvios e
+ * de TLB, também divididas pelo número de células (subproblemas) avaliadas. Os eventos que o
+ * processador ou o sistema (perf_event_paranoid) não oferecem são exibidos como indisponíveis. As
+ * fases que a estratégia escolhida não marca (por exemplo, a programação dinâmica das estratégias
+ * recursivas, periódica, em memória externa e anytime) são exibidas como não medidas, e não com
+ * contagens nulas.
  *
  * A função faz o tratamento dos possíveis erros, emite mensagens ao usuário e retorna o código
  * 0 (zero), indicado para o sistema operacional que sua execução foi realizada com sucesso.
@@ -42,34 +128,137 @@ int main(int argc, char* argv[])
     clock_t inicio = clock() /* Inicia a contagem do tempo. */, fim; // Variáveis para medição do tempo de execução.
     double segundos; // Variável auxiliar.
 
-    // Variáveis usadas para guardar o vetor com as caixas usadas no empilhamento,
-    // o tamanho do vetor e a solução ótima para o problema.
-    int *vetor_de_caixas_empilhadas = NULL, tam, solucao;
+    // Variável usada para guardar a solução ótima, o vetor com as caixas usadas no
+    // empilhamento e o tamanho do vetor.
+    solucao_empilhamento solucao;
+
+    // Opções de resolução, preenchidas a partir dos parâmetros passados via linha de comando.
+    opcoes_empilhamento opcoes;
+
+    // Estimativas do planejador de memória (parâmetro --mem-limit) e limite, em megabytes.
+    plano_resolucao plano;
+    double limite_memoria = 0;
+
+    // Diretório do cache de soluções (parâmetro --cache) e o seu tamanho máximo, em megabytes.
+    const char* diretorio_cache = NULL;
+    double tamanho_cache = TAMANHO_CACHE_PADRAO / (1024 * 1024);
+    int acerto = 0;
+
+    // Pilhas alternativas (parâmetro --top) e nome dos seus arquivos de saída.
+    solucao_empilhamento* alternativas = NULL;
+    char* nome_alternativa = NULL;
+
+    // Diretório do lote (parâmetro --spool), prazo das reservas e totais do processo.
+    const char* diretorio_lote = NULL;
+    double concessao = CONCESSAO_PADRAO;
+    resumo_lote resumo;
+
+    // Contadores de hardware por fase da resolução (parâmetro --perf) e nomes das fases e dos eventos.
+    perfil_fases perfil;
+    const char* nomes_fases[NUM_FASES] = { "GRAFO", "PROGRAMACAO DINAMICA", "RECONSTRUCAO" };
+    const char* nomes_eventos[NUM_EVENTOS] = { "CICLOS", "INSTRUCOES", "FALHAS L1", "FALHAS LLC",
+                                               "FALHAS DE DESVIO", "FALHAS DE TLB" };
+    long long* contagens; // Contagens de uma fase.
+    int medir_fases = 0, f, e;
 
     // Variáveis auxiliares, usadas no processamento dos parâmetros passados via linha de comando.
-    int ind_arquivo_entrada = 1, recursivo = 0;
+    int ind_arquivo_entrada = 1, estatisticas = 0, num_pilhas = 0, encontradas = 0, t;
 
     // Variável do tipo abstrato de dados (TAD) problema.
     problema p = NULL;
 
-    // A estrutura a seguir verifica se foram passados, no mínimo, 3 parâmetros (o nome do executável
-    // e os nomes dos arquivos de entrada e saída) via linha de comando.
-    if (argc < 3) {
-        printf("\nERRO: Ausencia de parametros!\nExecucao encerrada.\n");   // Caso haja menos de 3 parâmetros
-        return 0;                                                           // a execução é encerrada.
+    inicializa_opcoes(&opcoes); // Por padrão, a solução se dará pela função iterativa (bottom-up).
+
+    // A seguir verificam-se os parâmetros opcionais, que precedem os nomes dos arquivos.
+    while (ind_arquivo_entrada < argc && argv[ind_arquivo_entrada][0] == '-') {
+        if (strcmp(argv[ind_arquivo_entrada], "-r") == 0 || strcmp(argv[ind_arquivo_entrada], "-R") == 0)
+            opcoes.motor = MOTOR_TOP_DOWN; // Indica que se deseja executar a função recursiva (top-down).
+        else if (strcmp(argv[ind_arquivo_entrada], "-b") == 0 || strcmp(argv[ind_arquivo_entrada], "-B") == 0)
+            opcoes.motor = MOTOR_BRANCH_AND_BOUND; // Indica que se deseja executar a função com branch and bound.
+        else if (strcmp(argv[ind_arquivo_entrada], "-p") == 0 || strcmp(argv[ind_arquivo_entrada], "-P") == 0)
+            opcoes.motor = MOTOR_PERIODICO; // Indica que se deseja executar a função com detecção de período.
+        else if ((strcmp(argv[ind_arquivo_entrada], "-t") == 0 || strcmp(argv[ind_arquivo_entrada], "-T") == 0)
+                 && ind_arquivo_entrada + 1 < argc && atoi(argv[ind_arquivo_entrada + 1]) >= 0) {
+            opcoes.motor = MOTOR_PARALELO; // Indica que se deseja executar a função recursiva paralela.
+            opcoes.threads = atoi(argv[++ind_arquivo_entrada]); // Número de threads.
+        }
+        else if (strcmp(argv[ind_arquivo_entrada], "-x") == 0 || strcmp(argv[ind_arquivo_entrada], "-X") == 0)
+            opcoes.motor = MOTOR_EXTERNO; // Indica que se deseja executar a função em memória externa.
+        else if (strcmp(argv[ind_arquivo_entrada], "-w") == 0 || strcmp(argv[ind_arquivo_entrada], "-W") == 0)
+            opcoes.motor = MOTOR_JANELA; // Indica que se deseja executar a função com predecessores compactos.
+        else if (strcmp(argv[ind_arquivo_entrada], "-u") == 0 || strcmp(argv[ind_arquivo_entrada], "-U") == 0)
+            opcoes.motor = MOTOR_VALOR; // Indica que se deseja executar a função indexada pelo valor.
+        else if (strcmp(argv[ind_arquivo_entrada], "-d") == 0 || strcmp(argv[ind_arquivo_entrada], "-D") == 0)
+            opcoes.motor = MOTOR_DEGRAUS; // Indica que se deseja executar a função com degraus.
+        else if (strcmp(argv[ind_arquivo_entrada], "--checkpoint") == 0 && ind_arquivo_entrada + 1 < argc) {
+            opcoes.motor = MOTOR_EXTERNO; // Os pontos de verificação são gravados pela função em memória externa.
+            opcoes.externo.arquivo_checkpoint = argv[++ind_arquivo_entrada]; // Arquivo de pontos de verificação.
+        }
+        else if (strcmp(argv[ind_arquivo_entrada], "--resume") == 0)
+            opcoes.externo.retomar = 1; // Indica que se deseja continuar do último ponto de verificação.
+        else if (strcmp(argv[ind_arquivo_entrada], "--checkpoint-overhead") == 0 && ind_arquivo_entrada + 1 < argc
+                 && atof(argv[ind_arquivo_entrada + 1]) > 0)
+            opcoes.externo.sobrecarga_checkpoint = atof(argv[++ind_arquivo_entrada]); // Porcentagem admitida.
+        else if (strcmp(argv[ind_arquivo_entrada], "--deadline") == 0 && ind_arquivo_entrada + 1 < argc
+                 && atof(argv[ind_arquivo_entrada + 1]) > 0) {
+            opcoes.motor = MOTOR_ANYTIME; // Indica que se deseja executar a função com prazo.
+            opcoes.prazo = atof(argv[++ind_arquivo_entrada]) / 1000.0; // Prazo, em segundos.
+        }
+        else if (strcmp(argv[ind_arquivo_entrada], "--epsilon") == 0 && ind_arquivo_entrada + 1 < argc
+                 && atof(argv[ind_arquivo_entrada + 1]) > 0) {
+            opcoes.motor = MOTOR_APROXIMADO; // Indica que se deseja executar a função aproximada.
+            opcoes.epsilon = atof(argv[++ind_arquivo_entrada]); // Erro relativo das alturas.
+        }
+        else if (strcmp(argv[ind_arquivo_entrada], "--top") == 0 && ind_arquivo_entrada + 1 < argc
+                 && atoi(argv[ind_arquivo_entrada + 1]) > 0)
+            num_pilhas = atoi(argv[++ind_arquivo_entrada]); // Número de pilhas distintas desejadas.
+        else if (strcmp(argv[ind_arquivo_entrada], "--mem-limit") == 0 && ind_arquivo_entrada + 1 < argc
+                 && atof(argv[ind_arquivo_entrada + 1]) > 0)
+            limite_memoria = atof(argv[++ind_arquivo_entrada]); // Limite de memória, em megabytes.
+        else if (strcmp(argv[ind_arquivo_entrada], "--cache") == 0 && ind_arquivo_entrada + 1 < argc)
+            diretorio_cache = argv[++ind_arquivo_entrada]; // Diretório do cache de soluções.
+        else if (strcmp(argv[ind_arquivo_entrada], "--cache-size") == 0 && ind_arquivo_entrada + 1 < argc
+                 && atof(argv[ind_arquivo_entrada + 1]) > 0)
+            tamanho_cache = atof(argv[++ind_arquivo_entrada]); // Tamanho máximo do cache, em megabytes.
+        else if (strcmp(argv[ind_arquivo_entrada], "--spool") == 0 && ind_arquivo_entrada + 1 < argc)
+            diretorio_lote = argv[++ind_arquivo_entrada]; // Diretório do lote de instâncias.
+        else if (strcmp(argv[ind_arquivo_entrada], "--lease") == 0 && ind_arquivo_entrada + 1 < argc
+                 && atof(argv[ind_arquivo_entrada + 1]) > 0)
+            concessao = atof(argv[++ind_arquivo_entrada]); // Prazo das reservas, em segundos.
+        else if (strcmp(argv[ind_arquivo_entrada], "-s") == 0 || strcmp(argv[ind_arquivo_entrada], "-S") == 0)
+            opcoes.reduzir = 0; // Indica que a instância deve ser resolvida sem redução.
+        else if (strcmp(argv[ind_arquivo_entrada], "-e") == 0 || strcmp(argv[ind_arquivo_entrada], "-E") == 0)
+            estatisticas = 1; // Indica que se deseja exibir os contadores de esforço computacional.
+        else if (strcmp(argv[ind_arquivo_entrada], "--perf") == 0)
+            medir_fases = 1; // Indica que se deseja medir as fases com os contadores de hardware.
+        else {
+            printf("\nERRO: Parametro \"%s\" desconhecido!\nExecucao encerrada.\n", argv[ind_arquivo_entrada]);
+            return 0;
+        }
+        ind_arquivo_entrada++; // O nome do arquivo de entrada passa a ser o parâmetro seguinte.
     }
 
-    // A seguir verifica-se se o parâmetro opcional -r (ou -R) foi informado.
-    if (strcmp(argv[1], "-r") == 0 || strcmp(argv[1], "-R") == 0) {
-        if (argc < 4) { // Com o parâmetro -r (ou -R) deve haver 4 parâmetros.
-            printf("\nERRO: Ausencia de parametros!\nExecucao encerrada.\n");   // Caso haja menos de 4 parâmetros
-            return 0;                                                           // a execução é encerrada.
+    // Os contadores de acesso à memória só são abertos para a exibição com -e. Com --perf, os
+    // contadores por fase já incluem as falhas de TLB, e os dois conjuntos disputariam os registradores.
+    opcoes.contadores = estatisticas && !medir_fases;
+
+    if (diretorio_lote) { // Processa as instâncias do lote, em vez de um par de arquivos.
+        if (opcoes.externo.arquivo_checkpoint || opcoes.externo.retomar) { // Um único arquivo para todas as instâncias.
+            printf("\nERRO: --checkpoint e --resume nao podem ser usados com --spool!\nExecucao encerrada.\n");
+            return 0;
         }
+        if (processa_lote(diretorio_lote, &opcoes, concessao, &resumo) < 0)
+            printf("\nERRO: Problemas na leitura do diretorio \"%s\" ou na alocacao de memoria.\n", diretorio_lote);
+        printf("\nLOTE: %d resolvida(s), %d falha(s), %d reserva(s) recuperada(s), %.3f s de resolucao\n",
+               resumo.resolvidas, resumo.falhas, resumo.recuperadas, resumo.segundos);
+        return 0;
+    }
 
-        recursivo = 1;  // Se o parâmetro -r (ou -R) foi informado e há 4 parâmetros, no mínimo, a variável
-        // recursivo recebe 1 (um), como indicativo de que se deseja executar a função
-        // recursiva (top-down).
-        ind_arquivo_entrada++; // O nome do arquivo de entrada passa a ser o parâmetro seguinte ao -r (ou -R).
+    // A estrutura a seguir verifica se, após os parâmetros opcionais, foram passados os nomes
+    // dos arquivos de entrada e saída via linha de comando.
+    if (argc - ind_arquivo_entrada < 2) {
+        printf("\nERRO: Ausencia de parametros!\nExecucao encerrada.\n");   // Caso haja menos parâmetros
+        return 0;                                                           // a execução é encerrada.
     }
 
     // A seguir, o realiza-se o processamento do arquivo texto de entrada, para obtenção dos dados
@@ -80,32 +269,153 @@ int main(int argc, char* argv[])
 
     if (p) { // Verifica se o processamento do arquivo foi bem sucedido.
 
-        if (recursivo) // Analisa qual será a função usada na solução do problema.
-            solucao = empilhamento_top_down(p, &vetor_de_caixas_empilhadas, &tam); // Função recursiva.
-        else
-            solucao = empilhamento_bottom_up(p, &vetor_de_caixas_empilhadas, &tam); // Função iterativa.
+        if (diretorio_cache && num_pilhas == 0) { // Procura a instância no cache de soluções.
+            acerto = (consulta_cache(diretorio_cache, p, &solucao) == 1);
+            printf("\nCACHE: %s\n", acerto ? "acerto" : "ausente");
+        }
+
+        if (!acerto && limite_memoria > 0 && num_pilhas == 0) { // O planejador escolhe a estratégia que cabe no limite.
+            opcoes.motor = planeja_resolucao(p, limite_memoria * 1024 * 1024, &plano);
+
+            printf("\nPLANO DE MEMORIA (limite: %.1f MB, %lld empilhamentos examinados):\n",
+                   limite_memoria, plano.transicoes);
+            for(t = 0; t < NUM_CANDIDATOS_PLANO; t++)
+                printf("%-12s memoria: %12.1f MB   disco: %12.1f MB   tempo: %10.3f s   %s\n",
+                       nome_motor(plano.estimativas[t].motor), plano.estimativas[t].bytes / (1024 * 1024),
+                       plano.estimativas[t].bytes_disco / (1024 * 1024), plano.estimativas[t].segundos,
+                       plano.estimativas[t].cabe ? "cabe" : "nao cabe");
+            printf("ESTRATEGIA ESCOLHIDA: %s\n", (opcoes.motor >= 0) ? nome_motor(opcoes.motor) : "nenhuma");
+        }
+
+        if (num_pilhas > 0) { // Resolve o problema obtendo as k melhores pilhas distintas.
+            alternativas = (solucao_empilhamento*) malloc(sizeof(solucao_empilhamento) * num_pilhas);
+            encontradas = alternativas ? resolve_k_melhores(p, num_pilhas, alternativas) : -1;
+            solucao.valor = -1;
+            if (encontradas >= 0) {
+                solucao = alternativas[0]; // A melhor pilha (ou nenhuma, se não há pilha de valor positivo).
+                if (encontradas == 0)
+                    solucao.valor = solucao.limitante = 0;
+            }
+        } else if (acerto) {
+            // A solução veio do cache: nenhuma resolução é necessária.
+        } else if (opcoes.motor >= 0) { // Resolve o problema com a estratégia escolhida.
+            if (medir_fases) { // Os contadores ficam ativos durante toda a resolução.
+                inicia_perfil(&perfil);
+                p->perfil = &perfil;
+            }
+            resolve_empilhamento(p, &opcoes, &solucao);
+            if (medir_fases) {
+                encerra_perfil(&perfil);
+                p->perfil = NULL;
+            }
+            if (diretorio_cache && grava_cache(diretorio_cache, tamanho_cache * 1024 * 1024, p, &solucao))
+                printf("CACHE: solucao gravada\n");
+        } else
+            solucao.valor = -1; // Nenhuma estratégia cabe no limite de memória.
 
         termina_problema(p); // Desaloca a memória usada para armazenar os dados do problema.
 
-        if (solucao != -1) { // Se a variável contém o valor -1, houve falha de alocação de memória.
+        if (solucao.valor != -1) { // Se a variável contém o valor -1, houve falha de alocação de memória.
+
+            if (opcoes.motor == MOTOR_ANYTIME || opcoes.motor == MOTOR_APROXIMADO) {
+                // Exibe a qualidade comprovada da solução.
+                printf("\nLIMITANTE SUPERIOR: %d\n", solucao.limitante);
+                printf("GAP: %.4f%%\n", (solucao.limitante > 0) ?
+                       100.0 * (solucao.limitante - solucao.valor) / solucao.limitante : 0.0);
+                if (opcoes.motor == MOTOR_APROXIMADO)
+                    printf("RAZAO: %.6f\n", (solucao.limitante > 0) ?
+                           (double) solucao.valor / solucao.limitante : 1.0);
+            }
+
+            if (estatisticas) { // Exibe os contadores de esforço computacional.
+                printf("\nSUBPROBLEMAS AVALIADOS: %lld\n", solucao.est.subproblemas);
+                printf("EMPILHAMENTOS EXAMINADOS: %lld\n", solucao.est.transicoes);
+                printf("CAIXAS ELIMINADAS NA REDUCAO: %d\n", solucao.est.caixas_eliminadas);
+                printf("TEMPO DE CONSTRUCAO DOS EMPILHAMENTOS: %f segundos.\n", solucao.est.segundos_grafo);
+                printf("PAGINAS DAS TABELAS: %s\n", (solucao.est.tipo_paginas == PAGINAS_ENORMES) ? "enormes (hugetlbfs)" :
+                       (solucao.est.tipo_paginas == PAGINAS_TRANSPARENTES) ? "enormes transparentes (THP)" : "comuns");
+                if (solucao.est.falhas_tlb >= 0)
+                    printf("FALHAS DE TLB: %lld\n", solucao.est.falhas_tlb);
+                else
+                    printf("FALHAS DE TLB: indisponivel\n");
+                if (solucao.est.fracao_remota >= 0)
+                    printf("ACESSOS REMOTOS (NUMA): %.2f%%\n", 100.0 * solucao.est.fracao_remota);
+                else
+                    printf("ACESSOS REMOTOS (NUMA): indisponivel\n");
+            }
+
+            if (medir_fases && !acerto && num_pilhas == 0) { // Exibe os contadores de hardware por fase.
+                printf("\nPERFIL POR FASE (%d de %d eventos disponiveis, %lld celulas avaliadas):\n",
+                       eventos_disponiveis(&perfil), NUM_EVENTOS, solucao.est.subproblemas);
+                if (eventos_disponiveis(&perfil) == 0) // Sem contadores: apenas os tempos das fases.
+                    printf("CONTADORES DE HARDWARE: indisponiveis (processador ou perf_event_paranoid)\n");
+                for(f = 0; f < NUM_FASES; f++) {
+                    contagens = perfil.contagens[f];
+                    if (perfil.medicoes[f] == 0) { // A estratégia não marca esta fase.
+                        printf("%s: nao medida pela estrategia %s\n", nomes_fases[f], nome_motor(opcoes.motor));
+                        continue;
+                    }
+                    printf("%s: %f segundos\n", nomes_fases[f], perfil.segundos[f]);
+                    if (eventos_disponiveis(&perfil) == 0)
+                        continue;
+                    for(e = 0; e < NUM_EVENTOS; e++) {
+                        if (contagens[e] < 0)
+                            printf("    %-18s indisponivel\n", nomes_eventos[e]);
+                        else if (e >= EVENTO_FALHAS_L1 && solucao.est.subproblemas > 0)
+                            printf("    %-18s %lld (%.4f por celula)\n", nomes_eventos[e], contagens[e],
+                                   (double) contagens[e] / solucao.est.subproblemas);
+                        else
+                            printf("    %-18s %lld\n", nomes_eventos[e], contagens[e]);
+                    }
+                    if (contagens[EVENTO_CICLOS] > 0 && contagens[EVENTO_INSTRUCOES] >= 0)
+                        printf("    %-18s %.3f\n", "IPC", (double) contagens[EVENTO_INSTRUCOES] / contagens[EVENTO_CICLOS]);
+                    else
+                        printf("    %-18s indisponivel\n", "IPC");
+                }
+            }
 
             // A seguir, gera-se o arquivo de saída, conforme formato definido no enunciado do trabalho.
-            if (!gera_arquivo_saida(argv[(ind_arquivo_entrada + 1)], solucao, vetor_de_caixas_empilhadas, tam)) {
+            if (!gera_arquivo_saida(argv[(ind_arquivo_entrada + 1)], solucao.valor, solucao.caixas, solucao.tam)) {
                 // Se houve erro na geração do arquivo de saída, exibe mensagem de erro para o usuário.
                 printf("\nERRO: Problemas na gravação do arquivo \"%s\".\n", argv[(ind_arquivo_entrada + 1)]);
             }
 
-            if (vetor_de_caixas_empilhadas)
-                free(vetor_de_caixas_empilhadas); // Desaloca a memória usada para o vetor.
+            // As pilhas alternativas são gravadas em arquivos com os sufixos .2, .3, etc.
+            if (encontradas > 0)
+                printf("\nPILHAS DISTINTAS: %d\n", encontradas);
+            if (encontradas > 1)
+                nome_alternativa = (char*) malloc(strlen(argv[(ind_arquivo_entrada + 1)]) + 16);
+            for(t = 0; t < encontradas; t++) {
+                printf("PILHA %d: %d\n", t + 1, alternativas[t].valor);
+                if (t > 0 && nome_alternativa) {
+                    sprintf(nome_alternativa, "%s.%d", argv[(ind_arquivo_entrada + 1)], t + 1);
+                    if (!gera_arquivo_saida(nome_alternativa, alternativas[t].valor, alternativas[t].caixas, alternativas[t].tam))
+                        printf("\nERRO: Problemas na gravação do arquivo \"%s\".\n", nome_alternativa);
+                }
+                if (t > 0)
+                    termina_solucao(&alternativas[t]);
+            }
+            if (encontradas > 1 && !nome_alternativa)
+                printf("\nERRO: Problemas na alocação de memória.\n");
+
+            termina_solucao(&solucao); // Desaloca a memória usada para o vetor.
         } else {
             // Exibe mensagem de erro devido a falha na alocação de memória para resolução do problema.
-            printf("\nERRO: Problemas na alocação de memória.\n");
+            if (opcoes.motor < 0)
+                printf("\nERRO: Nenhuma estrategia cabe no limite de memoria.\n");
+            else if (opcoes.motor == MOTOR_EXTERNO) // A função em memória externa também depende de arquivos.
+                printf("\nERRO: Problemas na alocação de memória ou nos arquivos de índices/checkpoint.\n");
+            else
+                printf("\nERRO: Problemas na alocação de memória.\n");
         }
     } else {
         // Exibe mensagem de erro ocasionada no processamento do arquivo texto de entrada.
         printf("\nERRO: Problemas na abertura/leitura/processamento do arquivo \"%s\".\n", argv[ind_arquivo_entrada]);
     }
 
+    free(alternativas);
+    free(nome_alternativa);
+
     fim = clock(); // Termina a contagem de tempo de execução do programa.
     segundos = ((double) fim - inicio) / ((double) CLOCKS_PER_SEC); // Converte o tempo para segundos.
     printf("\nTEMPO DE EXECUCAO: %.3f\n", segundos); // Exibe o tempo de execução do programa.
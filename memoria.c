@@ -0,0 +1,242 @@
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "memoria.h"
+
+/* Alocação das tabelas da programação dinâmica, que têm (h + 1) * n células e ocupam, nas
+ * instâncias grandes, gigabytes. Em páginas de 4 KiB, os acessos espalhados por linhas distantes
+ * da tabela esgotam a TLB; em páginas de 2 MiB, cada entrada da TLB cobre 512 vezes mais memória.
+ *
+ * A alocação tenta, nesta ordem:
+ *
+ *      - páginas enormes reservadas (mmap com MAP_HUGETLB), que exigem páginas previamente
+ *        reservadas pelo administrador (/proc/sys/vm/nr_hugepages);
+ *      - páginas enormes transparentes: um mapeamento alinhado a 2 MiB, marcado com
+ *        madvise(MADV_HUGEPAGE), que o núcleo preenche com páginas enormes quando possível;
+ *      - malloc, para tabelas pequenas ou sistemas sem mmap.
+ *
+ * Um cabeçalho, gravado imediatamente antes do endereço retornado, registra como a tabela foi
+ * obtida, para que a função libera_tabela a devolva da mesma forma.
+ */
+
+#define TAMANHO_PAGINA_ENORME ((size_t) 2 * 1024 * 1024) // Tamanho das páginas enormes (2 MiB).
+#define TAMANHO_CABECALHO 64 // Espaço reservado ao cabeçalho, que preserva o alinhamento da tabela.
+
+/* Cabeçalho de uma tabela. */
+typedef struct {
+    void* inicio; // Endereço do mapeamento ou do bloco obtido com malloc.
+    size_t tamanho; // Tamanho do mapeamento (0 se obtido com malloc).
+} cabecalho_tabela;
+
+
+/* Aloca uma tabela com o número de bytes informado, em páginas enormes sempre que possível. O
+ * parâmetro tipo, se não for NULL, recebe o tipo de página obtido (uma das constantes PAGINAS_*).
+ * O conteúdo da tabela não é inicializado.
+ *
+ * Retorna o endereço da tabela, que deve ser liberada com a função libera_tabela, ou NULL em caso
+ * de falha na alocação de memória.
+ *
+ * Complexidade: O(1)
+ */
+void* aloca_tabela(size_t bytes, int* tipo)
+{
+    cabecalho_tabela cab; // Cabeçalho da tabela.
+    char* base = NULL; // Início da área útil do mapeamento.
+    size_t tamanho, excesso; // Variáveis auxiliares.
+    int obtido = PAGINAS_COMUNS; // Tipo de página obtido.
+
+    if (bytes > SIZE_MAX - TAMANHO_CABECALHO - 2 * TAMANHO_PAGINA_ENORME)
+        return NULL; // O tamanho excede o espaço de endereçamento.
+
+    // Tamanho arredondado para um múltiplo de páginas enormes.
+    tamanho = (bytes + TAMANHO_CABECALHO + TAMANHO_PAGINA_ENORME - 1) / TAMANHO_PAGINA_ENORME * TAMANHO_PAGINA_ENORME;
+
+    if (bytes >= TAMANHO_PAGINA_ENORME) { // Tabelas menores do que uma página enorme usam malloc.
+#if defined(MAP_HUGETLB)
+        base = (char*) mmap(NULL, tamanho, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base == (char*) MAP_FAILED)
+            base = NULL;
+        else {
+            cab.inicio = base;
+            cab.tamanho = tamanho;
+            obtido = PAGINAS_ENORMES;
+        }
+#endif
+
+#if defined(MADV_HUGEPAGE)
+        if (!base) {
+            // Mapeia uma página enorme a mais, para alinhar o início, e devolve as sobras.
+            base = (char*) mmap(NULL, tamanho + TAMANHO_PAGINA_ENORME, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (base == (char*) MAP_FAILED)
+                base = NULL;
+            else {
+                excesso = (TAMANHO_PAGINA_ENORME - (uintptr_t) base % TAMANHO_PAGINA_ENORME) % TAMANHO_PAGINA_ENORME;
+                if (excesso > 0)
+                    munmap(base, excesso);
+                munmap(base + excesso + tamanho, TAMANHO_PAGINA_ENORME - excesso);
+                base += excesso;
+
+                madvise(base, tamanho, MADV_HUGEPAGE); // Sem suporte a THP, seguem páginas comuns.
+                cab.inicio = base;
+                cab.tamanho = tamanho;
+                obtido = PAGINAS_TRANSPARENTES;
+            }
+        }
+#endif
+    }
+
+    if (!base) {
+        base = (char*) malloc(bytes + TAMANHO_CABECALHO);
+        if (!base)
+            return NULL; // Falha, devido à ausência de recursos computacionais.
+        cab.inicio = base;
+        cab.tamanho = 0;
+        obtido = PAGINAS_COMUNS;
+    }
+
+    memcpy(base + TAMANHO_CABECALHO - sizeof(cabecalho_tabela), &cab, sizeof(cabecalho_tabela));
+
+    if (tipo)
+        *tipo = obtido;
+
+    return base + TAMANHO_CABECALHO;
+} // fim da função aloca_tabela
+
+
+/* Libera uma tabela alocada com a função aloca_tabela. Aceita NULL.
+ *
+ * Complexidade: O(1)
+ */
+void libera_tabela(void* tabela)
+{
+    cabecalho_tabela cab; // Cabeçalho da tabela.
+
+    if (!tabela)
+        return;
+
+    memcpy(&cab, (char*) tabela - sizeof(cabecalho_tabela), sizeof(cabecalho_tabela));
+
+    if (cab.tamanho > 0)
+        munmap(cab.inicio, cab.tamanho);
+    else
+        free(cab.inicio);
+} // fim da função libera_tabela
+
+
+/* Abre um contador de hardware para a thread chamadora e as threads criadas por ela a partir de
+ * então, apenas em modo usuário. As leituras trazem os tempos em que o contador esteve habilitado
+ * e ativo, para a correção das contagens quando o núcleo reveza os contadores (ver
+ * le_contador_memoria). Retorna o descritor do contador ou -1, se o evento não é suportado pelo
+ * processador ou o sistema não permite o acesso (perf_event_paranoid).
+ *
+ * Complexidade: O(1)
+ */
+int abre_contador_memoria(unsigned int tipo, unsigned long long evento)
+{
+#if defined(__linux__)
+    struct perf_event_attr atributos; // Descrição do evento.
+
+    memset(&atributos, 0, sizeof(atributos));
+    atributos.size = sizeof(atributos);
+    atributos.type = tipo;
+    atributos.config = evento;
+    atributos.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    atributos.inherit = 1; // Inclui as threads da estratégia paralela.
+    atributos.exclude_kernel = 1;
+    atributos.exclude_hv = 1;
+
+    return (int) syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0);
+#else
+    (void) tipo;
+    (void) evento;
+    return -1;
+#endif
+} // fim da função abre_contador_memoria
+
+
+/* Lê um contador aberto com a função abre_contador_memoria, sem fechá-lo. Se o contador foi
+ * revezado com outros, a contagem é extrapolada para todo o tempo em que esteve habilitado.
+ * Retorna a contagem ou -1, se o contador não está disponível ou se, habilitado, nunca chegou a
+ * ser ativado.
+ *
+ * Complexidade: O(1)
+ */
+long long le_contador_memoria(int descritor)
+{
+    uint64_t leitura[3]; // Contagem, tempo habilitado e tempo ativo.
+
+    if (descritor < 0 || read(descritor, leitura, sizeof(leitura)) != (ssize_t) sizeof(leitura))
+        return -1;
+
+    if (leitura[2] == 0) // O contador ainda não foi ativado: só há contagem se nunca esteve habilitado.
+        return (leitura[1] == 0) ? 0 : -1;
+
+    if (leitura[2] < leitura[1]) // Contador revezado com outros: extrapola para o tempo todo.
+        return (long long) ((double) leitura[0] * leitura[1] / leitura[2]);
+
+    return (long long) leitura[0];
+} // fim da função le_contador_memoria
+
+
+/* Lê e fecha um contador aberto com a função abre_contador_memoria. Retorna a contagem ou -1, se
+ * o contador não está disponível.
+ *
+ * Complexidade: O(1)
+ */
+long long fecha_contador_memoria(int descritor)
+{
+    long long contagem = le_contador_memoria(descritor); // Valor lido.
+
+    if (descritor >= 0)
+        close(descritor);
+
+    return contagem;
+} // fim da função fecha_contador_memoria
+
+
+/* Inicia a contagem de falhas de TLB e de acessos a memória local e remota (NUMA) em leituras
+ * de dados. Os contadores indisponíveis são ignorados.
+ *
+ * Complexidade: O(1)
+ */
+void inicia_contadores_memoria(contadores_memoria* c)
+{
+#if defined(__linux__)
+    c->falhas_tlb = abre_contador_memoria(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    c->acessos_no = abre_contador_memoria(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_NODE |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16));
+    c->acessos_remotos = abre_contador_memoria(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_NODE |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#else
+    c->falhas_tlb = c->acessos_no = c->acessos_remotos = -1;
+#endif
+} // fim da função inicia_contadores_memoria
+
+
+/* Encerra a contagem iniciada com a função inicia_contadores_memoria e grava nas estatísticas o
+ * número de falhas de TLB e a fração de acessos à memória que foram a outro nó NUMA (-1 para os
+ * contadores indisponíveis).
+ *
+ * Complexidade: O(1)
+ */
+void encerra_contadores_memoria(contadores_memoria* c, estatisticas_empilhamento* est)
+{
+    long long acessos, remotos; // Contagens de acessos à memória.
+
+    est->falhas_tlb = fecha_contador_memoria(c->falhas_tlb);
+    acessos = fecha_contador_memoria(c->acessos_no);
+    remotos = fecha_contador_memoria(c->acessos_remotos);
+    est->fracao_remota = (acessos > 0 && remotos >= 0) ? (double) remotos / acessos : -1;
+
+    c->falhas_tlb = c->acessos_no = c->acessos_remotos = -1;
+} // fim da função encerra_contadores_memoria
@@ -0,0 +1,33 @@
+#ifndef MEMORIA_H_INCLUDED
+#define MEMORIA_H_INCLUDED
+
+#include <stddef.h>
+#include "estruturas.h"
+
+/* Tipos de página obtidos para uma tabela (campo tipo_paginas das estatísticas): */
+#define PAGINAS_COMUNS 0 // Páginas de 4 KiB (malloc).
+#define PAGINAS_TRANSPARENTES 1 // Páginas enormes transparentes (madvise, THP).
+#define PAGINAS_ENORMES 2 // Páginas enormes reservadas (hugetlbfs).
+
+/* Descritores dos contadores de hardware de acesso à memória (-1 se indisponível). */
+typedef struct {
+    int falhas_tlb; // Falhas de TLB em leituras de dados.
+    int acessos_no; // Leituras de dados que chegaram à memória de algum nó NUMA.
+    int acessos_remotos; // Leituras de dados que chegaram à memória de outro nó NUMA.
+} contadores_memoria;
+
+void* aloca_tabela(size_t, int*);
+
+void libera_tabela(void*);
+
+int abre_contador_memoria(unsigned int, unsigned long long);
+
+long long le_contador_memoria(int);
+
+long long fecha_contador_memoria(int);
+
+void inicia_contadores_memoria(contadores_memoria*);
+
+void encerra_contadores_memoria(contadores_memoria*, estatisticas_empilhamento*);
+
+#endif // MEMORIA_H_INCLUDED
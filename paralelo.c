@@ -0,0 +1,426 @@
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "paralelo.h"
+#include "memoria.h"
+
+/* Estratégia recursiva (top-down) paralela. Cada caixa da base é uma tarefa e, durante o cálculo
+ * de subproblemas altos, os subproblemas filhos ainda não calculados também são publicados como
+ * tarefas. Cada thread mantém uma fila dupla de tarefas (algoritmo de Chase e Lev): a própria thread
+ * insere e retira tarefas em uma extremidade e as demais threads roubam tarefas da outra.
+ *
+ * A tabela de memorização é compartilhada por todas as threads e não utiliza travas: cada célula
+ * é reivindicada com uma operação atômica de comparação e troca (CAS), passando de CELULA_VAZIA
+ * para CELULA_EM_CALCULO, e o valor calculado é publicado com uma escrita atômica de liberação.
+ * Assim, nenhum subproblema é calculado duas vezes. Uma thread que precisa de uma célula em
+ * cálculo por outra thread aguarda a sua publicação. Como cada subproblema depende apenas de
+ * subproblemas de altura estritamente menor, essas esperas nunca formam um ciclo.
+ *
+ * Apenas os subproblemas alcançáveis a partir das caixas da base são calculados, como na
+ * estratégia recursiva sequencial.
+ *
+ * As threads consultam o controle da resolução a cada INTERVALO_CONTROLE tarefas e a cada
+ * INTERVALO_CANCELAMENTO subproblemas calculados, e a thread 0 (zero) informa também o progresso.
+ * Um pedido de cancelamento interrompe todas as threads.
+ *
+ * As tabelas são alocadas em páginas enormes (ver memoria.c) e inicializadas pela thread principal,
+ * antes da criação das demais.
+ */
+
+#define CELULA_VAZIA (-1) // O subproblema ainda não foi reivindicado.
+#define CELULA_EM_CALCULO (-2) // O subproblema está sendo calculado por alguma thread.
+#define CAPACIDADE_FILA 4096 // Número máximo de tarefas em cada fila dupla.
+#define TAREFA_NULA (-1LL) // Indica a ausência de tarefas.
+#define TAMANHO_PILHA_THREAD (64 * 1024 * 1024) // Tamanho da pilha de execução de cada thread.
+#define LINHA_CACHE 64 // Tamanho de uma linha de cache, em bytes.
+#define INTERVALO_CANCELAMENTO 4096 // Subproblemas calculados por uma thread entre duas consultas ao controle.
+
+/* Fila dupla de tarefas, com capacidade fixa. Cada tarefa codifica um subproblema (h, caixa)
+ * como h * n + caixa. */
+typedef struct {
+    _Atomic long long topo; // Extremidade em que as outras threads roubam tarefas.
+    _Atomic long long base; // Extremidade em que a thread dona insere e retira tarefas.
+    _Atomic long long tarefas[CAPACIDADE_FILA]; // Vetor circular de tarefas.
+} fila_dupla;
+
+/* Dados compartilhados por todas as threads de uma resolução. */
+typedef struct {
+    problema p; // O problema em resolução.
+    lista* vetor_lista_de_caixas_empilhaveis; // Listas de caixas empilháveis.
+    _Atomic int* emp; // Tabela de memorização, com (h + 1) * n células.
+    int** matriz_indices; // Sequências de empilhamentos.
+    fila_dupla* filas; // Uma fila dupla por thread.
+    int num_threads; // Número de threads.
+    int limiar_tarefa; // Altura mínima para que um subproblema filho seja publicado como tarefa.
+    int raizes_publicadas; // Número de caixas da base inseridas como tarefas nas filas.
+    atomic_int raizes_concluidas; // Número de caixas da base cujo subproblema já foi publicado.
+    atomic_int cancelar; // Se diferente de zero, as threads abandonam as tarefas restantes.
+} contexto_paralelo;
+
+/* Dados de cada thread. Os contadores, atualizados a cada subproblema, ficam em uma linha de
+ * cache própria, para que as threads não disputem a mesma linha (falso compartilhamento). */
+typedef struct {
+    contexto_paralelo* ctx; // Dados compartilhados.
+    int id; // Índice da thread (e de sua fila dupla).
+    _Alignas(LINHA_CACHE) estatisticas_empilhamento est; // Contadores da thread, somados ao final.
+} contexto_thread;
+
+
+/* Insere uma tarefa na fila dupla (somente a thread dona). Retorna 0 (zero) se a fila está cheia. */
+int insere_tarefa(fila_dupla* f, long long tarefa)
+{
+    long long b = atomic_load_explicit(&f->base, memory_order_relaxed);
+    long long t = atomic_load_explicit(&f->topo, memory_order_acquire);
+
+    if (b - t >= CAPACIDADE_FILA)
+        return 0;
+
+    atomic_store_explicit(&f->tarefas[b % CAPACIDADE_FILA], tarefa, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&f->base, b + 1, memory_order_relaxed);
+    return 1;
+} // fim da função insere_tarefa
+
+
+/* Retira a tarefa inserida mais recentemente (somente a thread dona). */
+long long retira_tarefa(fila_dupla* f)
+{
+    long long b = atomic_load_explicit(&f->base, memory_order_relaxed) - 1, t, tarefa;
+
+    atomic_store_explicit(&f->base, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    t = atomic_load_explicit(&f->topo, memory_order_relaxed);
+
+    if (t > b) { // Fila vazia.
+        atomic_store_explicit(&f->base, b + 1, memory_order_relaxed);
+        return TAREFA_NULA;
+    }
+
+    tarefa = atomic_load_explicit(&f->tarefas[b % CAPACIDADE_FILA], memory_order_relaxed);
+
+    if (t == b) { // Última tarefa: disputa com as threads que tentam roubá-la.
+        if (!atomic_compare_exchange_strong_explicit(&f->topo, &t, t + 1,
+                memory_order_seq_cst, memory_order_relaxed))
+            tarefa = TAREFA_NULA;
+        atomic_store_explicit(&f->base, b + 1, memory_order_relaxed);
+    }
+
+    return tarefa;
+} // fim da função retira_tarefa
+
+
+/* Rouba a tarefa mais antiga da fila dupla de outra thread. */
+long long rouba_tarefa(fila_dupla* f)
+{
+    long long t = atomic_load_explicit(&f->topo, memory_order_acquire), b, tarefa;
+
+    atomic_thread_fence(memory_order_seq_cst);
+    b = atomic_load_explicit(&f->base, memory_order_acquire);
+
+    if (t >= b) // Fila vazia.
+        return TAREFA_NULA;
+
+    tarefa = atomic_load_explicit(&f->tarefas[t % CAPACIDADE_FILA], memory_order_relaxed);
+
+    if (!atomic_compare_exchange_strong_explicit(&f->topo, &t, t + 1,
+            memory_order_seq_cst, memory_order_relaxed))
+        return TAREFA_NULA; // Outra thread levou a tarefa.
+
+    return tarefa;
+} // fim da função rouba_tarefa
+
+
+/* Consulta o controle da resolução. A thread 0 (zero), que é a thread que chamou a estratégia,
+ * informa o progresso (caixas da base concluídas) e verifica o pedido de cancelamento; as demais
+ * apenas verificam o pedido. Um pedido é repassado a todas as threads pelo contexto.
+ *
+ * Retorna 1 (um) se a resolução deve ser interrompida ou 0 (zero), caso contrário.
+ *
+ * Complexidade: O(1), mais a da função de acompanhamento do progresso.
+ */
+int verifica_cancelamento(contexto_thread* th)
+{
+    contexto_paralelo* ctx = th->ctx; // Dados compartilhados.
+    problema p = ctx->p; // O problema em resolução.
+    int pedido; // Indica se o cancelamento foi pedido.
+
+    if (atomic_load_explicit(&ctx->cancelar, memory_order_relaxed))
+        return 1;
+
+    if (th->id == 0)
+        pedido = acompanha_resolucao(p, atomic_load_explicit(&ctx->raizes_concluidas, memory_order_relaxed), p->n);
+    else
+        pedido = p->controle && atomic_load_explicit(&p->controle->cancelar, memory_order_relaxed);
+
+    if (pedido)
+        atomic_store_explicit(&ctx->cancelar, 1, memory_order_relaxed);
+
+    return pedido;
+} // fim da função verifica_cancelamento
+
+
+/* Calcula (ou obtém da tabela de memorização) a solução ótima do subproblema (h, indice_caixa).
+ * Se a célula está vazia, a thread a reivindica e a calcula; se está em cálculo por outra thread,
+ * aguarda a publicação do valor.
+ *
+ * Após um pedido de cancelamento, nenhuma célula é reivindicada ou aguardada: a função retorna 0
+ * (zero), e as células já reivindicadas são concluídas rapidamente, com valores que serão
+ * descartados.
+ *
+ * Complexidade: O(nh), como na função empilhamento_recursiva.
+ */
+int empilhamento_recursiva_paralela(int h, int indice_caixa, contexto_thread* th)
+{
+    contexto_paralelo* ctx = th->ctx; // Dados compartilhados.
+    problema p = ctx->p; // O problema em resolução.
+    _Atomic int* celula = &ctx->emp[(long long) h * p->n + indice_caixa]; // Célula do subproblema.
+    int valor = atomic_load_explicit(celula, memory_order_acquire), esperado = CELULA_VAZIA;
+    int j, h_aux, emp_aux, indice = -1; // Variáveis auxiliares.
+    _Atomic int* anterior; // Linha h - a(i) da tabela de memorização.
+    tipo_nodo *no; // Variável auxiliar utilizada para percorrer a lista de caixas empilháveis.
+
+    if (valor >= 0) // O subproblema já foi calculado.
+        return valor;
+
+    if (atomic_load_explicit(&ctx->cancelar, memory_order_relaxed)) // Resolução interrompida.
+        return 0;
+
+    if (valor == CELULA_EM_CALCULO || !atomic_compare_exchange_strong_explicit(celula, &esperado,
+            CELULA_EM_CALCULO, memory_order_acq_rel, memory_order_acquire)) {
+        // Outra thread está calculando o subproblema: aguarda a publicação do valor.
+        while ((valor = atomic_load_explicit(celula, memory_order_acquire)) < 0)
+            sched_yield();
+        return valor;
+    }
+
+    valor = 0;
+    h_aux = h - p->caixas[indice_caixa].a; // Subtrai a altura da caixa da altura h.
+
+    if (h_aux >= 0) { // Se o valor anterior for não-negativo, a caixa cabe na pilha.
+
+        th->est.subproblemas++;
+        th->est.transicoes += ctx->vetor_lista_de_caixas_empilhaveis[indice_caixa]->tamanho;
+
+        if (th->est.subproblemas % INTERVALO_CANCELAMENTO == 0)
+            verifica_cancelamento(th);
+
+        // Subproblemas filhos altos, ainda não reivindicados, são publicados como tarefas,
+        // para que outras threads possam calculá-los enquanto esta percorre a lista.
+        if (h_aux >= ctx->limiar_tarefa && ctx->num_threads > 1)
+            for(no = ctx->vetor_lista_de_caixas_empilhaveis[indice_caixa]->first; no; no = no->next)
+                if (atomic_load_explicit(&ctx->emp[(long long) h_aux * p->n + no->item.chave],
+                                         memory_order_relaxed) == CELULA_VAZIA)
+                    if (!insere_tarefa(&ctx->filas[th->id], (long long) h_aux * p->n + no->item.chave))
+                        break; // Fila cheia: os filhos restantes serão calculados por esta thread.
+
+        anterior = ctx->emp + (long long) h_aux * p->n;
+        for(no = ctx->vetor_lista_de_caixas_empilhaveis[indice_caixa]->first; no; no = no->next) {
+            j = no->item.chave; // Cada nó da lista contém o índice de uma caixa que é empilhável.
+
+            // A maior parte dos subproblemas filhos já está calculada: a célula é consultada antes
+            // da chamada recursiva, que só ocorre para as células vazias ou em cálculo.
+            emp_aux = atomic_load_explicit(&anterior[j], memory_order_acquire);
+            if (emp_aux < 0)
+                emp_aux = empilhamento_recursiva_paralela(h_aux, j, th);
+            emp_aux += p->v[indice_caixa];
+
+            if (emp_aux > valor) {
+                valor = emp_aux;
+                if (emp_aux > p->v[indice_caixa]) // O índice só é registrado se a caixa
+                    indice = j;                   // for empilhada com outra(s).
+            }
+        }
+    }
+
+    // A sequência de empilhamento é gravada antes da publicação do valor, que a torna visível.
+    ctx->matriz_indices[h][indice_caixa] = indice;
+    atomic_store_explicit(celula, valor, memory_order_release);
+
+    if (h == p->h) // As células da linha h correspondem às caixas da base.
+        atomic_fetch_add_explicit(&ctx->raizes_concluidas, 1, memory_order_release);
+
+    return valor;
+} // fim da função empilhamento_recursiva_paralela
+
+
+/* Laço de execução de cada thread: retira tarefas da própria fila ou rouba tarefas das filas
+ * das demais threads, até que os subproblemas de todas as caixas da base publicadas como tarefas
+ * estejam calculados. A cada INTERVALO_CONTROLE tarefas, consulta o controle da resolução; após um
+ * pedido de cancelamento, descarta as tarefas da própria fila.
+ */
+void* executa_thread(void* arg)
+{
+    contexto_thread* th = (contexto_thread*) arg; // Dados da thread.
+    contexto_paralelo* ctx = th->ctx; // Dados compartilhados.
+    long long tarefa, tentativas = 0; // Tarefa em execução e número de tarefas procuradas.
+    int i; // Variável auxiliar.
+
+    while (atomic_load_explicit(&ctx->raizes_concluidas, memory_order_acquire) < ctx->raizes_publicadas) {
+        if (tentativas++ % INTERVALO_CONTROLE == 0 && verifica_cancelamento(th)) {
+            while (retira_tarefa(&ctx->filas[th->id]) != TAREFA_NULA)
+                ; // Descarta as tarefas restantes.
+            break;
+        }
+
+        tarefa = retira_tarefa(&ctx->filas[th->id]);
+
+        // Sem tarefas próprias, tenta roubar de cada uma das demais threads.
+        for(i = 1; tarefa == TAREFA_NULA && i < ctx->num_threads; i++)
+            tarefa = rouba_tarefa(&ctx->filas[(th->id + i) % ctx->num_threads]);
+
+        if (tarefa == TAREFA_NULA)
+            sched_yield(); // Nenhuma tarefa disponível no momento.
+        else
+            empilhamento_recursiva_paralela((int) (tarefa / ctx->p->n), (int) (tarefa % ctx->p->n), th);
+    }
+
+    return NULL;
+} // fim da função executa_thread
+
+
+/* Encontra a solução ótima para o problema de empilhamento de caixas, utilizando a estratégia
+ * recursiva (top down) paralela descrita no início do arquivo. O parâmetro num_threads define
+ * o número de threads (se for menor ou igual a zero, usa-se o número de processadores).
+ *
+ * Os demais parâmetros e os valores de retorno são os mesmos da função empilhamento_top_down.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n²h), dividida entre as threads.
+ */
+int empilhamento_top_down_paralelo(problema p, int num_threads, int** vetor_de_caixas_empilhadas, int* tam)
+{
+    contexto_paralelo ctx; // Dados compartilhados pelas threads.
+    contexto_thread* threads = NULL; // Dados de cada thread.
+    pthread_t* ids = NULL; // Identificadores das threads.
+    pthread_attr_t atributos; // Atributos das threads (tamanho da pilha de execução).
+    int i, k, criadas = 0, pos = 0, solucao_otima = -1, maior_altura = 1; // Variáveis auxiliares.
+    long long c; // Célula das tabelas.
+
+    // Verifica se a variável passada como parâmetro representa memória alocada.
+    if (*vetor_de_caixas_empilhadas)
+        free(*vetor_de_caixas_empilhadas); // Libera a memória alocada.
+
+    *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
+    *tam = 0;                           // referência e que retornarão valores também.
+
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
+    if (num_threads <= 0)
+        num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_threads <= 0)
+        num_threads = 1;
+
+    for(i = 0; i < p->n; i++)
+        if (p->caixas[i].a > maior_altura)
+            maior_altura = p->caixas[i].a;
+
+    ctx.p = p;
+    ctx.num_threads = num_threads;
+    ctx.limiar_tarefa = (p->h / 8 > maior_altura) ? p->h / 8 : maior_altura;
+    atomic_init(&ctx.raizes_concluidas, 0);
+    atomic_init(&ctx.cancelar, 0);
+    ctx.vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p);
+    ctx.emp = (_Atomic int*) aloca_tabela(sizeof(_Atomic int) * (p->h + 1) * p->n, &p->est.tipo_paginas);
+    ctx.matriz_indices = (int**) malloc(sizeof(int*) * (p->h + 1));
+    ctx.filas = (fila_dupla*) malloc(sizeof(fila_dupla) * num_threads);
+    threads = (contexto_thread*) aligned_alloc(LINHA_CACHE, sizeof(contexto_thread) * num_threads);
+    ids = (pthread_t*) malloc(sizeof(pthread_t) * num_threads);
+
+    if (ctx.matriz_indices)
+        ctx.matriz_indices[0] = (int*) aloca_tabela(sizeof(int) * (p->h + 1) * p->n, &p->est.tipo_paginas);
+
+    if (ctx.vetor_lista_de_caixas_empilhaveis && ctx.emp && ctx.matriz_indices && ctx.matriz_indices[0] &&
+            ctx.filas && threads && ids) {
+
+        for(k = 1; k <= p->h; k++)
+            ctx.matriz_indices[k] = ctx.matriz_indices[k - 1] + p->n;
+
+        // A linha 0 (zero) tem solução conhecida; as demais células estão vazias.
+        for(c = 0; c < (long long) (p->h + 1) * p->n; c++) {
+            atomic_init(&ctx.emp[c], (c < p->n) ? 0 : CELULA_VAZIA);
+            ctx.matriz_indices[0][c] = -1;
+        }
+
+        // As caixas da base são distribuídas, alternadamente, entre as filas das threads.
+        for(i = 0; i < num_threads; i++) {
+            atomic_init(&ctx.filas[i].topo, 0);
+            atomic_init(&ctx.filas[i].base, 0);
+            threads[i].ctx = &ctx;
+            threads[i].id = i;
+            threads[i].est.subproblemas = 0;
+            threads[i].est.transicoes = 0;
+        }
+        // Conta as caixas publicadas (nenhuma, sem altura disponível, pois não há subproblemas a calcular).
+        ctx.raizes_publicadas = 0;
+        for(i = p->n - 1; i >= 0 && p->h > 0; i--, ctx.raizes_publicadas++)
+            if (!insere_tarefa(&ctx.filas[i % num_threads], (long long) p->h * p->n + i))
+                break; // As caixas restantes serão calculadas ao final, pela thread principal.
+
+        pthread_attr_init(&atributos);
+        pthread_attr_setstacksize(&atributos, TAMANHO_PILHA_THREAD);
+
+        // A thread principal também participa, como a thread de índice 0 (zero).
+        for(criadas = 1; criadas < num_threads; criadas++)
+            if (pthread_create(&ids[criadas], &atributos, executa_thread, &threads[criadas]) != 0)
+                break;
+
+        pthread_attr_destroy(&atributos);
+
+        // A thread principal participa do laço de tarefas desde o início. As tarefas das filas de
+        // threads que não puderam ser criadas são roubadas pelas demais.
+        executa_thread(&threads[0]);
+
+        for(i = 1; i < criadas; i++)
+            pthread_join(ids[i], NULL);
+
+        // As caixas da base que não couberam nas filas são calculadas ao final, pela thread
+        // principal; as demais já estão na tabela de memorização.
+        for(i = 0; i < p->n && p->h > 0 && !atomic_load(&ctx.cancelar); i++)
+            empilhamento_recursiva_paralela(p->h, i, &threads[0]);
+
+        // Descarta as tarefas das filas de threads que não puderam ser criadas.
+        for(i = criadas; i < num_threads; i++)
+            while (retira_tarefa(&ctx.filas[i]) != TAREFA_NULA)
+                ;
+
+        for(i = 0; i < criadas; i++) { // Soma os contadores das threads.
+            p->est.subproblemas += threads[i].est.subproblemas;
+            p->est.transicoes += threads[i].est.transicoes;
+        }
+
+        // Como as soluções não diminuem com a altura, a solução ótima está na linha h.
+        for(i = 1; i < p->n; i++)
+            if (ctx.emp[(long long) p->h * p->n + i] > ctx.emp[(long long) p->h * p->n + pos])
+                pos = i;
+        solucao_otima = ctx.emp[(long long) p->h * p->n + pos];
+
+        if (atomic_load(&ctx.cancelar)) // Resolução interrompida: os valores da tabela não são válidos.
+            solucao_otima = RESOLUCAO_CANCELADA;
+        else if (solucao_otima > 0) { // Se a variável é maior do que 0 (zero), uma solução ótima foi encontrada.
+            (*vetor_de_caixas_empilhadas) = reconstroi_pilha(ctx.matriz_indices, p->caixas, p->n, p->h, pos, tam);
+
+            if (!(*vetor_de_caixas_empilhadas)) // Verifica se a alocação foi bem sucedida.
+                solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
+        }
+    }
+
+    // Libera todos os recursos alocados.
+    if (ctx.vetor_lista_de_caixas_empilhaveis)
+        termina_vetor_lista_de_caixas_empilhaveis(ctx.vetor_lista_de_caixas_empilhaveis, p->n);
+    if (ctx.matriz_indices)
+        libera_tabela(ctx.matriz_indices[0]);
+    free(ctx.matriz_indices);
+    libera_tabela((void*) ctx.emp);
+    free(ctx.filas);
+    free(threads);
+    free(ids);
+
+    return solucao_otima; // Retorna a solução ótima ou -1, em caso de falha na alocação de memória.
+} // fim da função empilhamento_top_down_paralelo
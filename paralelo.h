@@ -0,0 +1,8 @@
+#ifndef PARALELO_H_INCLUDED
+#define PARALELO_H_INCLUDED
+
+#include "estruturas.h"
+
+int empilhamento_top_down_paralelo(problema, int, int**, int*);
+
+#endif // PARALELO_H_INCLUDED
@@ -0,0 +1,87 @@
+#include <stdlib.h>
+#include "pequeno.h"
+#include "grafo.h"
+#include "perfil.h"
+
+/* Estratégia iterativa (bottom-up) para instâncias pequenas, com até MAX_CAIXAS_PEQUENO caixas e
+ * tabelas de até MAX_CELULAS_PEQUENO células, como as do conjunto arquivos/s*.data. Nelas, o custo
+ * da estratégia geral está na alocação das tabelas e das listas encadeadas de caixas empilháveis e
+ * no percurso dessas listas, não no cálculo.
+ *
+ * Aqui, a relação de empilhamento é guardada em linhas de bits de 1, 2 ou 4 palavras de 64 bits,
+ * e as tabelas ficam na pilha de execução. Cada largura de linha gera uma função própria (modelo em
+ * pequeno_modelo.h), em que o laço sobre as palavras tem tamanho conhecido na compilação; as caixas
+ * empilháveis são percorridas bit a bit, pelas instruções de contagem de zeros.
+ *
+ * A função empilhamento_bottom_up_pequeno escolhe a largura pelo número de caixas, e a função
+ * resolve_empilhamento a usa automaticamente no lugar da estratégia iterativa geral sempre que a
+ * instância (já reduzida) é pequena o bastante.
+ */
+
+#define PALAVRAS_PEQUENO 1
+#define FUNCAO_PEQUENO empilhamento_bottom_up_64
+#include "pequeno_modelo.h"
+#undef PALAVRAS_PEQUENO
+#undef FUNCAO_PEQUENO
+
+#define PALAVRAS_PEQUENO 2
+#define FUNCAO_PEQUENO empilhamento_bottom_up_128
+#include "pequeno_modelo.h"
+#undef PALAVRAS_PEQUENO
+#undef FUNCAO_PEQUENO
+
+#define PALAVRAS_PEQUENO 4
+#define FUNCAO_PEQUENO empilhamento_bottom_up_256
+#include "pequeno_modelo.h"
+#undef PALAVRAS_PEQUENO
+#undef FUNCAO_PEQUENO
+
+
+/* Retorna o número de palavras de 64 bits (1, 2 ou 4) das linhas de bits da estratégia para
+ * instâncias pequenas, ou 0 (zero) se o problema é grande demais para ela.
+ *
+ * Complexidade: O(1)
+ */
+int palavras_pequeno(problema p)
+{
+    if (p->n > MAX_CAIXAS_PEQUENO || (long long) (p->h + 1) * p->n > MAX_CELULAS_PEQUENO)
+        return 0;
+
+    return (p->n <= 64) ? 1 : (p->n <= 128) ? 2 : 4;
+} // fim da função palavras_pequeno
+
+
+/* Encontra a solução ótima para o problema de empilhamento de caixas, utilizando a estratégia para
+ * instâncias pequenas com a menor largura de linha que comporta o problema. Problemas grandes demais
+ * são resolvidos pela estratégia iterativa geral.
+ *
+ * Os parâmetros e os valores de retorno são os mesmos da função empilhamento_bottom_up.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n²h / 64 + nh + T), em que T é o número de empilhamentos examinados.
+ */
+int empilhamento_bottom_up_pequeno(problema p, int** vetor_de_caixas_empilhadas, int* tam)
+{
+    // Verifica se a variável passada como parâmetro representa memória alocada.
+    if (*vetor_de_caixas_empilhadas)
+        free(*vetor_de_caixas_empilhadas); // Libera a memória alocada.
+
+    *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
+    *tam = 0;                           // referência e que retornarão valores também.
+
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
+    switch (palavras_pequeno(p)) {
+    case 1:
+        return empilhamento_bottom_up_64(p, vetor_de_caixas_empilhadas, tam);
+    case 2:
+        return empilhamento_bottom_up_128(p, vetor_de_caixas_empilhadas, tam);
+    case 4:
+        return empilhamento_bottom_up_256(p, vetor_de_caixas_empilhadas, tam);
+    }
+
+    return empilhamento_bottom_up(p, vetor_de_caixas_empilhadas, tam);
+} // fim da função empilhamento_bottom_up_pequeno
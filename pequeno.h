@@ -0,0 +1,16 @@
+#ifndef PEQUENO_H_INCLUDED
+#define PEQUENO_H_INCLUDED
+
+#include "estruturas.h"
+
+/* Maior número de caixas (rotações) da estratégia para instâncias pequenas: 4 palavras de 64 bits. */
+#define MAX_CAIXAS_PEQUENO 256
+
+/* Maior número de células (h + 1) * n das tabelas, alocadas na pilha de execução. */
+#define MAX_CELULAS_PEQUENO 32768
+
+int palavras_pequeno(problema);
+
+int empilhamento_bottom_up_pequeno(problema, int**, int*);
+
+#endif // PEQUENO_H_INCLUDED
@@ -0,0 +1,118 @@
+/* Modelo da estratégia iterativa para instâncias pequenas, incluído por pequeno.c uma vez para
+ * cada largura de linha. Antes da inclusão, PALAVRAS_PEQUENO deve definir o número de palavras de
+ * 64 bits de cada linha de caixas empilháveis, e FUNCAO_PEQUENO, o nome da função gerada. Por
+ * isso, este arquivo não tem proteção contra inclusões múltiplas.
+ */
+
+/* Encontra a solução ótima para o problema de empilhamento de caixas, com n <= 64·PALAVRAS_PEQUENO
+ * caixas e (h + 1)·n <= MAX_CELULAS_PEQUENO, utilizando a estratégia iterativa (bottom-up) com
+ * linhas de bits de tamanho fixo e tabelas na pilha de execução.
+ *
+ * Os parâmetros e os valores de retorno são os mesmos da função empilhamento_bottom_up.
+ *
+ * Complexidade: O(n²h / 64 + nh + T), em que T é o número de empilhamentos examinados.
+ */
+int FUNCAO_PEQUENO(problema p, int** vetor_de_caixas_empilhadas, int* tam)
+{
+    unsigned long long empilhaveis[64 * PALAVRAS_PEQUENO][PALAVRAS_PEQUENO]; // Linhas de bits.
+    int emp[MAX_CELULAS_PEQUENO]; // Matriz de soluções ótimas, linha a linha.
+    short indices[MAX_CELULAS_PEQUENO]; // Matriz de sequências de empilhamentos, linha a linha.
+    unsigned long long bits; // Palavra em percurso.
+    const int *anterior; // Linha k - a_i da matriz de soluções ótimas.
+    int i, j, k, w, melhor, escolhida, pos = 0, n = p->n; // Variáveis auxiliares.
+    double inicio; // Início da construção das linhas de bits.
+
+    inicia_fase(p, FASE_GRAFO);
+    inicio = instante_atual();
+    for(i = 0; i < n; i++) {
+        // A função marca_empilhaveis grava apenas PALAVRAS_LINHA(n) palavras, e o laço abaixo percorre
+        // sempre PALAVRAS_PEQUENO: as palavras excedentes (por exemplo, a quarta linha de 256 bits
+        // com 129 a 192 caixas) devem estar zeradas, ou produziriam índices j >= n.
+        for(w = PALAVRAS_LINHA(n); w < PALAVRAS_PEQUENO; w++)
+            empilhaveis[i][w] = 0;
+        marca_empilhaveis(p->l, p->p, n, p->l[i], p->p[i], empilhaveis[i]);
+    }
+    p->est.segundos_grafo = instante_atual() - inicio;
+    encerra_fase(p, FASE_GRAFO);
+
+    inicia_fase(p, FASE_PROGRAMACAO);
+    for(i = 0; i < n; i++) { // A linha 0 (zero) não tem pilhas.
+        emp[i] = 0;
+        indices[i] = -1;
+    }
+
+    for(k = 1; k <= p->h; k++) {
+        for(i = 0; i < n; i++) {
+            melhor = 0;
+            escolhida = -1;
+
+            if (p->a[i] <= k) { // A caixa cabe na pilha.
+                p->est.subproblemas++;
+                anterior = emp + (k - p->a[i]) * n;
+
+                // Percorre as caixas empilháveis sobre i, palavra a palavra (laço de tamanho fixo,
+                // desenrolado pelo compilador), na ordem crescente de índices.
+                for(w = 0; w < PALAVRAS_PEQUENO; w++) {
+                    bits = empilhaveis[i][w];
+                    p->est.transicoes += __builtin_popcountll(bits);
+                    while (bits) {
+                        j = w * 64 + __builtin_ctzll(bits);
+                        bits &= bits - 1;
+                        if (anterior[j] > melhor) {
+                            melhor = anterior[j];
+                            escolhida = j;
+                        }
+                    }
+                }
+
+                melhor += p->v[i];
+                if (melhor <= 0) { // Como na estratégia iterativa, pilhas sem valor positivo valem 0 (zero).
+                    melhor = 0;
+                    escolhida = -1;
+                }
+            }
+
+            emp[k * n + i] = melhor;
+            indices[k * n + i] = (short) escolhida;
+        }
+
+        // Informa o progresso e verifica se houve pedido de cancelamento, como na estratégia iterativa.
+        if ((k % INTERVALO_CONTROLE == 0 || k == p->h) && acompanha_resolucao(p, k, p->h)) {
+            encerra_fase(p, FASE_PROGRAMACAO);
+            return RESOLUCAO_CANCELADA;
+        }
+    }
+
+    // As soluções não diminuem com a altura: a solução ótima está na linha h.
+    for(i = 1; i < n; i++)
+        if (emp[p->h * n + i] > emp[p->h * n + pos])
+            pos = i;
+    encerra_fase(p, FASE_PROGRAMACAO);
+
+    if (n == 0 || emp[p->h * n + pos] <= 0)
+        return 0; // Nenhuma caixa cabe na pilha.
+
+    // Reconstrução: a primeira passagem conta as caixas e a segunda as grava.
+    inicia_fase(p, FASE_RECONSTRUCAO);
+    for(j = 0, k = p->h, i = pos; i >= 0; j++) {
+        w = indices[k * n + i];
+        k -= p->a[i];
+        i = w;
+    }
+
+    *vetor_de_caixas_empilhadas = (int*) malloc(sizeof(int) * j);
+    if (!(*vetor_de_caixas_empilhadas)) {
+        encerra_fase(p, FASE_RECONSTRUCAO);
+        return -1; // Falha, devido à ausência de recursos computacionais.
+    }
+
+    for(*tam = 0, k = p->h, i = pos; i >= 0; (*tam)++) {
+        (*vetor_de_caixas_empilhadas)[*tam] = i;
+        w = indices[k * n + i];
+        k -= p->a[i];
+        i = w;
+    }
+    encerra_fase(p, FASE_RECONSTRUCAO);
+
+    return emp[p->h * n + pos]; // Retorna a solução ótima.
+} // fim da função FUNCAO_PEQUENO
@@ -0,0 +1,137 @@
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#endif
+#include "perfil.h"
+#include "memoria.h"
+#include "grafo.h"
+
+/* Medição das fases de uma resolução (construção da relação de empilhamento, laço da programação
+ * dinâmica e reconstrução da pilha) com os contadores de hardware do processador, para distinguir
+ * a causa de uma regressão: falhas de cache ou de TLB, desvios previstos incorretamente ou número
+ * de instruções.
+ *
+ * Os contadores são abertos uma única vez, antes da resolução, e ficam ativos até o fim; cada fase
+ * lê os contadores no início e no fim e acumula a diferença. Cada evento tem o seu contador (e não
+ * um grupo), aberto com as funções de memoria.c, para que um evento indisponível não impeça a
+ * contagem dos demais. Quando há mais eventos do que registradores, o núcleo reveza os contadores,
+ * e as leituras são corrigidas pela fração do tempo em que cada um esteve ativo.
+ *
+ * As estratégias chamam inicia_fase e encerra_fase com o problema que resolvem; sem medição (campo
+ * perfil nulo), as chamadas não fazem nada.
+ */
+
+
+/* Abre os contadores dos eventos EVENTO_* e zera as contagens, os tempos e o número de medições
+ * de todas as fases. As contagens dos eventos indisponíveis ficam com -1.
+ *
+ * Complexidade: O(1)
+ */
+void inicia_perfil(perfil_fases* perfil)
+{
+    int e, f; // Variáveis auxiliares.
+
+#if defined(__linux__)
+    perfil->descritores[EVENTO_CICLOS] = abre_contador_memoria(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    perfil->descritores[EVENTO_INSTRUCOES] = abre_contador_memoria(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    perfil->descritores[EVENTO_FALHAS_L1] = abre_contador_memoria(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    perfil->descritores[EVENTO_FALHAS_LLC] = abre_contador_memoria(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    perfil->descritores[EVENTO_FALHAS_DESVIO] = abre_contador_memoria(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    perfil->descritores[EVENTO_FALHAS_TLB] = abre_contador_memoria(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#else
+    for(e = 0; e < NUM_EVENTOS; e++)
+        perfil->descritores[e] = -1;
+#endif
+
+    for(f = 0; f < NUM_FASES; f++) {
+        perfil->segundos[f] = 0;
+        perfil->medicoes[f] = 0;
+        for(e = 0; e < NUM_EVENTOS; e++)
+            perfil->contagens[f][e] = (perfil->descritores[e] >= 0) ? 0 : -1;
+    }
+} // fim da função inicia_perfil
+
+
+/* Fecha os contadores abertos pela função inicia_perfil. As contagens acumuladas são mantidas.
+ *
+ * Complexidade: O(1)
+ */
+void encerra_perfil(perfil_fases* perfil)
+{
+    int e; // Variável auxiliar.
+
+    for(e = 0; e < NUM_EVENTOS; e++) {
+        fecha_contador_memoria(perfil->descritores[e]);
+        perfil->descritores[e] = -1;
+    }
+} // fim da função encerra_perfil
+
+
+/* Retorna o número de eventos contados em alguma fase (0 se o processador ou o sistema não
+ * oferecem contadores de hardware). Pode ser consultada após a função encerra_perfil.
+ *
+ * Complexidade: O(1)
+ */
+int eventos_disponiveis(const perfil_fases* perfil)
+{
+    int e, f, disponiveis = 0; // Variáveis auxiliares.
+
+    for(e = 0; e < NUM_EVENTOS; e++) {
+        for(f = 0; f < NUM_FASES && perfil->contagens[f][e] < 0; f++)
+            ;
+        disponiveis += (f < NUM_FASES);
+    }
+
+    return disponiveis;
+} // fim da função eventos_disponiveis
+
+
+/* Marca o início de uma fase (uma das constantes FASE_*) da resolução do problema p: guarda o
+ * instante e a leitura de cada contador. Não faz nada se o problema não tem medição.
+ *
+ * Complexidade: O(1)
+ */
+void inicia_fase(problema p, int fase)
+{
+    int e; // Variável auxiliar.
+
+    (void) fase;
+    if (!p->perfil)
+        return;
+
+    for(e = 0; e < NUM_EVENTOS; e++)
+        p->perfil->marcas[e] = le_contador_memoria(p->perfil->descritores[e]);
+    p->perfil->inicio = instante_atual(); // Por último, para não medir as leituras.
+} // fim da função inicia_fase
+
+
+/* Marca o fim de uma fase iniciada com a função inicia_fase e acumula, na fase, o tempo decorrido
+ * e a diferença entre as leituras dos contadores, contando mais uma medição. Um evento que não pôde ser lido passa a
+ * indisponível na fase (-1). Não faz nada se o problema não tem medição.
+ *
+ * Complexidade: O(1)
+ */
+void encerra_fase(problema p, int fase)
+{
+    perfil_fases* perfil = p->perfil; // Medição do problema.
+    double fim; // Instante do fim da fase.
+    long long leitura; // Leitura de um contador.
+    int e; // Variável auxiliar.
+
+    if (!perfil)
+        return;
+
+    fim = instante_atual(); // Primeiro, para não medir as leituras.
+    perfil->segundos[fase] += fim - perfil->inicio;
+    perfil->medicoes[fase]++;
+
+    for(e = 0; e < NUM_EVENTOS; e++) {
+        leitura = le_contador_memoria(perfil->descritores[e]);
+        if (leitura < 0 || perfil->marcas[e] < 0)
+            perfil->contagens[fase][e] = -1;
+        else if (perfil->contagens[fase][e] >= 0)
+            perfil->contagens[fase][e] += leitura - perfil->marcas[e];
+    }
+} // fim da função encerra_fase
@@ -0,0 +1,16 @@
+#ifndef PERFIL_H_INCLUDED
+#define PERFIL_H_INCLUDED
+
+#include "estruturas.h"
+
+void inicia_perfil(perfil_fases*);
+
+void encerra_perfil(perfil_fases*);
+
+int eventos_disponiveis(const perfil_fases*);
+
+void inicia_fase(problema, int);
+
+void encerra_fase(problema, int);
+
+#endif // PERFIL_H_INCLUDED
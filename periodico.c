@@ -0,0 +1,304 @@
+#include <stdlib.h>
+#include <limits.h>
+#include "periodico.h"
+
+/* Estratégia de resolução para alturas máximas muito grandes, baseada na periodicidade da
+ * programação dinâmica.
+ *
+ * Seja f(k, i) o valor da melhor pilha de altura máxima k apoiada na caixa i e r* a melhor
+ * razão valor/altura dentre todas as caixas. As caixas cujas pilhas podem alcançar a razão r*
+ * (conjunto S) crescem, para k grande, exatamente à taxa r*; as demais crescem a uma taxa
+ * menor e, a partir de uma altura K que pode ser calculada, deixam de participar de qualquer
+ * empilhamento ótimo. A partir daí, as colunas de S formam um sistema fechado, invariante por
+ * translação: se A linhas consecutivas (A é a maior altura de caixa) satisfazem
+ * f(k, i) = f(k - P, i) + D para toda caixa i de S, então todas as linhas seguintes também o
+ * satisfazem, com as mesmas escolhas de caixas empilhadas. Essa verificação explícita prova o
+ * período P, e a solução para qualquer altura maior é obtida diretamente, sem calcular as
+ * linhas restantes. Se nenhum período é provado até a altura h, a tabela completa é calculada,
+ * como na estratégia iterativa.
+ */
+
+#define MAX_CANDIDATOS_PERIODO 64 // Número máximo de períodos candidatos verificados.
+
+
+/* Calcula o máximo divisor comum de dois inteiros não negativos.
+ *
+ * Complexidade: O(log(min(x, y)))
+ */
+long long mdc(long long x, long long y)
+{
+    long long t; // Variável auxiliar.
+
+    while (y != 0) {
+        t = x % y;
+        x = y;
+        y = t;
+    }
+    return x;
+} // fim da função mdc
+
+
+/* Identifica as caixas do conjunto S (aquelas a partir das quais se alcança a melhor razão r*)
+ * e calcula a altura K a partir da qual as caixas fora de S não participam de empilhamentos
+ * ótimos. Uma caixa m de razão r* garante f(k, m) >= v(m) * piso(k / a(m)) > r*k - v(m), enquanto
+ * uma caixa j fora de S, com razão alcançável s(j) < r*, garante apenas f(k, j) <= s(j)k. Assim,
+ * basta que k(r* - s(j)) >= v(m) para toda caixa m de razão r*.
+ *
+ * Os parâmetros de entrada são o problema, as razões alcançáveis de cada caixa, a melhor razão
+ * global e o vetor (de tamanho n) que receberá a indicação de pertinência a S.
+ *
+ * Retorna a altura K.
+ *
+ * Complexidade: O(n)
+ */
+long long calcula_altura_dominancia(problema p, razao_caixa* razao, razao_caixa melhor, char* em_s)
+{
+    long long k_dom = 0, v_max = 0, num, den; // Variáveis auxiliares.
+    int i; // Variável auxiliar.
+
+    // Maior valor dentre as caixas cuja própria razão é r*.
+    for(i = 0; i < p->n; i++)
+        if ((long long) p->v[i] * melhor.a == (long long) melhor.v * p->caixas[i].a && p->v[i] > v_max)
+            v_max = p->v[i];
+
+    for(i = 0; i < p->n; i++) {
+        em_s[i] = ((long long) razao[i].v * melhor.a == (long long) melhor.v * razao[i].a);
+
+        if (!em_s[i]) {
+            // k >= v_max / (r* - s(i)), com as razões representadas por frações.
+            num = (long long) v_max * melhor.a * razao[i].a;
+            den = (long long) melhor.v * razao[i].a - (long long) razao[i].v * melhor.a;
+            if ((num + den - 1) / den > k_dom)
+                k_dom = (num + den - 1) / den;
+        }
+    }
+
+    return k_dom;
+} // fim da função calcula_altura_dominancia
+
+
+/* Obtém a caixa empilhada sobre a caixa de índice i, em uma pilha de altura máxima h. Se h está
+ * além da última linha calculada (k), a consulta é feita na linha equivalente do período.
+ *
+ * Complexidade: O(1)
+ */
+int predecessor_periodico(int* indices, int n, long long k, long long periodo, long long h, int i)
+{
+    if (h > k) // Desloca h por um número inteiro de períodos, até a faixa calculada.
+        h -= ((h - k + periodo - 1) / periodo) * periodo;
+
+    return indices[h * n + i];
+} // fim da função predecessor_periodico
+
+
+/* Encontra a solução ótima para o problema de empilhamento de caixas através da programação
+ * dinâmica iterativa, interrompida assim que o regime periódico das soluções é provado (veja a
+ * descrição no início do arquivo). A pilha da solução é reconstruída repetindo-se o bloco
+ * periódico de caixas tantas vezes quanto necessário.
+ *
+ * Os parâmetros e os valores de retorno são os mesmos da função empilhamento_bottom_up. A função
+ * também retorna -1 se o valor da solução ótima não puder ser representado por um int.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n²K), onde K é a altura em que o período é provado (no máximo h).
+ */
+int empilhamento_periodico(problema p, int** vetor_de_caixas_empilhadas, int* tam)
+{
+    int *emp = NULL, *indices = NULL, *aux; // Tabelas, guardadas linha a linha em vetores contíguos.
+    int **matriz_emp, **matriz_indices; // Referências às linhas, para a reconstrução sem período.
+    int *consecutivas; // Número de linhas consecutivas que confirmam cada período candidato.
+    char *em_s; // Indica se a caixa pertence ao conjunto S.
+    razao_caixa *razao, melhor; // Melhores razões alcançáveis e melhor razão global (r*).
+    lista *vetor_lista_de_caixas_empilhaveis; // Listas de caixas empilháveis.
+    tipo_nodo *no; // Variável auxiliar utilizada para percorrer a lista de caixas empilháveis.
+    long long k, capacidade = 0, inicio_verificacao, passo, ganho, periodo = 0, h, voltas, valor;
+    int i, j, m, h_aux, maior_altura = 0, linha, pos, solucao_otima = -1, falha = 0, cancelada = 0; // Variáveis auxiliares.
+
+    // Verifica se a variável passada como parâmetro representa memória alocada.
+    if (*vetor_de_caixas_empilhadas)
+        free(*vetor_de_caixas_empilhadas); // Libera a memória alocada.
+
+    *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
+    *tam = 0;                           // referência e que retornarão valores também.
+
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
+    vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p);
+    razao = (razao_caixa*) malloc(sizeof(razao_caixa) * p->n);
+    em_s = (char*) malloc(sizeof(char) * p->n);
+    consecutivas = (int*) calloc(MAX_CANDIDATOS_PERIODO + 1, sizeof(int));
+
+    if (vetor_lista_de_caixas_empilhaveis && razao && em_s && consecutivas) {
+
+        // Melhor razão global (r*) e maior altura de caixa (A).
+        calcula_melhores_razoes(p->caixas, p->v, p->n, razao);
+        melhor = razao[0];
+        for(i = 0; i < p->n; i++) {
+            if ((long long) razao[i].v * melhor.a > (long long) melhor.v * razao[i].a)
+                melhor = razao[i];
+            if (p->caixas[i].a > maior_altura)
+                maior_altura = p->caixas[i].a;
+        }
+
+        // A verificação de um período P só começa quando as linhas k - P, comparadas com as
+        // linhas k, estão além de K e de A (a partir de A, todas as caixas cabem na pilha).
+        inicio_verificacao = calcula_altura_dominancia(p, razao, melhor, em_s);
+        if (inicio_verificacao < maior_altura)
+            inicio_verificacao = maior_altura;
+
+        // Como D = P * r* deve ser inteiro, os períodos candidatos são múltiplos de passo,
+        // e cada passo acrescenta ganho ao valor das soluções.
+        passo = (melhor.v > 0) ? melhor.a / mdc(melhor.v, melhor.a) : 1;
+        ganho = (melhor.v > 0) ? melhor.v / mdc(melhor.v, melhor.a) : 0;
+
+        for(k = 0; k <= p->h && !periodo; k++) {
+
+            if (k >= capacidade) { // Amplia as tabelas, dobrando a sua capacidade.
+                capacidade = (capacidade > 0) ? 2 * capacidade : 1024;
+                if (capacidade > (long long) p->h + 1)
+                    capacidade = (long long) p->h + 1;
+
+                aux = (int*) realloc(emp, sizeof(int) * capacidade * p->n);
+                if (!aux) {
+                    falha = 1;
+                    break;
+                }
+                emp = aux;
+
+                aux = (int*) realloc(indices, sizeof(int) * capacidade * p->n);
+                if (!aux) {
+                    falha = 1;
+                    break;
+                }
+                indices = aux;
+            }
+
+            // Cálculo da linha k, idêntico ao da estratégia iterativa.
+            for(i = 0; i < p->n; i++) {
+                emp[k * p->n + i] = 0;
+                indices[k * p->n + i] = -1;
+
+                h_aux = k - p->caixas[i].a;
+
+                if (h_aux >= 0) {
+                    p->est.subproblemas++;
+                    p->est.transicoes += vetor_lista_de_caixas_empilhaveis[i]->tamanho;
+
+                    for(no = vetor_lista_de_caixas_empilhaveis[i]->first; no; no = no->next) {
+                        j = no->item.chave;
+                        if ((p->v[i] + emp[(long long) h_aux * p->n + j]) > emp[k * p->n + i]) {
+                            emp[k * p->n + i] = p->v[i] + emp[(long long) h_aux * p->n + j];
+                            if (emp[(long long) h_aux * p->n + j] != 0)
+                                indices[k * p->n + i] = j;
+                        }
+                    }
+                }
+            }
+
+            // Verifica cada período candidato P = m * passo: a linha k deve ser igual à linha
+            // k - P acrescida de m * ganho, em todas as colunas de S.
+            for(m = 1; m <= MAX_CANDIDATOS_PERIODO && !periodo; m++) {
+                if (k - m * passo < inicio_verificacao)
+                    break; // Os candidatos seguintes são ainda maiores.
+
+                for(i = 0; i < p->n; i++)
+                    if (em_s[i] && emp[k * p->n + i] != emp[(k - m * passo) * p->n + i] + m * ganho)
+                        break;
+
+                consecutivas[m] = (i == p->n) ? consecutivas[m] + 1 : 0;
+
+                if (consecutivas[m] >= maior_altura) // A linhas consecutivas provam o período.
+                    periodo = m * passo;
+            }
+
+            // Informa o progresso e verifica se houve pedido de cancelamento.
+            if ((k % INTERVALO_CONTROLE == 0 || k == p->h) && acompanha_resolucao(p, k, p->h)) {
+                cancelada = 1;
+                break;
+            }
+        }
+
+        k--; // Última linha calculada.
+
+        if (cancelada) { // Resolução interrompida: não há pilha.
+            solucao_otima = RESOLUCAO_CANCELADA;
+
+        } else if (!falha && !periodo) { // Tabela completa: reconstrução como na estratégia iterativa.
+            matriz_emp = (int**) malloc(sizeof(int*) * (p->h + 1));
+            matriz_indices = (int**) malloc(sizeof(int*) * (p->h + 1));
+
+            if (matriz_emp && matriz_indices) {
+                for(i = 0; i <= p->h; i++) {
+                    matriz_emp[i] = emp + (long long) i * p->n;
+                    matriz_indices[i] = indices + (long long) i * p->n;
+                }
+
+                solucao_otima = seleciona_base(matriz_emp, p->n, p->h, &linha, &pos);
+
+                if (solucao_otima > 0) {
+                    (*vetor_de_caixas_empilhadas) = reconstroi_pilha(matriz_indices, p->caixas, p->n, linha, pos, tam);
+                    if (!(*vetor_de_caixas_empilhadas))
+                        solucao_otima = -1;
+                }
+            }
+
+            free(matriz_emp);
+            free(matriz_indices);
+
+        } else if (!falha) { // Período provado: salto direto até a altura h.
+
+            // Linha equivalente a h, dentro do último período calculado.
+            voltas = ((long long) p->h - k + periodo - 1) / periodo;
+            linha = (int) (p->h - voltas * periodo);
+
+            pos = 0;
+            for(i = 1; i < p->n; i++)
+                if (emp[(long long) linha * p->n + i] > emp[(long long) linha * p->n + pos])
+                    pos = i;
+
+            valor = emp[(long long) linha * p->n + pos] + voltas * (periodo / passo) * ganho;
+
+            if (valor == 0) { // Nenhuma caixa tem valor positivo: a pilha é vazia.
+                solucao_otima = 0;
+
+            } else if (valor <= INT_MAX) { // O valor deve ser representável por um int.
+                solucao_otima = (int) valor;
+
+                // Conta as caixas da pilha, percorrendo-a uma primeira vez.
+                for(h = p->h, i = pos; i != -1; (*tam)++) {
+                    j = predecessor_periodico(indices, p->n, k, periodo, h, i);
+                    h -= p->caixas[i].a;
+                    i = j;
+                }
+
+                (*vetor_de_caixas_empilhadas) = (int*) malloc(sizeof(int) * (*tam));
+
+                if (*vetor_de_caixas_empilhadas) { // Preenche a pilha em um segundo percurso.
+                    for(h = p->h, i = pos, m = 0; i != -1; m++) {
+                        (*vetor_de_caixas_empilhadas)[m] = i;
+                        j = predecessor_periodico(indices, p->n, k, periodo, h, i);
+                        h -= p->caixas[i].a;
+                        i = j;
+                    }
+                } else {
+                    *tam = 0;
+                    solucao_otima = -1;
+                }
+            }
+        }
+    }
+
+    // Libera todos os recursos alocados.
+    if (vetor_lista_de_caixas_empilhaveis)
+        termina_vetor_lista_de_caixas_empilhaveis(vetor_lista_de_caixas_empilhaveis, p->n);
+    free(razao);
+    free(em_s);
+    free(consecutivas);
+    free(emp);
+    free(indices);
+
+    return solucao_otima; // Retorna a solução ótima ou -1, em caso de falha.
+} // fim da função empilhamento_periodico
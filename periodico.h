@@ -0,0 +1,8 @@
+#ifndef PERIODICO_H_INCLUDED
+#define PERIODICO_H_INCLUDED
+
+#include "estruturas.h"
+
+int empilhamento_periodico(problema, int**, int*);
+
+#endif // PERIODICO_H_INCLUDED
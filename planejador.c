@@ -0,0 +1,118 @@
+#include <stdlib.h>
+#include "planejador.h"
+#include "empilhamento.h"
+#include "externo.h"
+#include "janela.h"
+#include "valores.h"
+#include "grafo.h"
+
+/* Planejador de memória: antes de qualquer alocação das tabelas, estima a memória e o tempo de
+ * cada estratégia exata a partir de n, h, do número de empilhamentos e das alturas mínima e
+ * máxima das caixas, e escolhe a mais rápida que cabe no limite de memória.
+ *
+ *      - Tabela completa (iterativa): duas matrizes de (h + 1)n inteiros.
+ *      - Janela de valores com predecessores compactos: A + 1 linhas de valores (A é a maior
+ *        altura) e (h + 1)n predecessores de 1, 2 ou 4 bytes (ver janela.c).
+ *      - Memória externa: A + 1 linhas de valores e o buffer do arquivo; os (h + 1)n índices vão
+ *        para o disco (ver externo.c).
+ *      - Tabela indexada pelo valor: (W + 1)n inteiros, em que W = floor(r·h) limita o valor de
+ *        qualquer pilha (ver valores.c).
+ *
+ * As três primeiras examinam os mesmos empilhamentos, cujo número é calculado exatamente: a
+ * caixa i, com g(i) caixas empilháveis sobre ela, é examinada nas linhas a(i) a h. Na tabela
+ * indexada pelo valor, ela é examinada no máximo nas linhas v(i) + 1 a W (a resolução termina na
+ * primeira linha sem pilha viável, de modo que a estimativa é pessimista). Cada exame é
+ * um pouco mais caro com a janela circular (cálculo da linha k - a(i) na janela); o tempo estimado
+ * soma a esse custo o da primeira escrita das tabelas e o do acesso ao disco. As estratégias
+ * recursivas calculam menos subproblemas, mas alocam as mesmas tabelas completas, e por isso não
+ * são candidatas à parte.
+ */
+
+
+/* Estima a memória e o tempo de cada estratégia para o problema p e escolhe a mais rápida cuja
+ * memória estimada não excede limite bytes (se limite for menor ou igual a zero, não há limite).
+ * As estimativas e a escolha são gravadas em plano, para que possam ser exibidas.
+ *
+ * Retorna a estratégia escolhida (uma das constantes MOTOR_*) ou -1, se nenhuma cabe no limite ou
+ * em caso de falha na alocação de memória.
+ *
+ * Complexidade: O(n²)
+ */
+int planeja_resolucao(problema p, double limite, plano_resolucao* plano)
+{
+    unsigned long long *bits; // Linha de bits das caixas empilháveis sobre uma caixa.
+    double celulas, celulas_valor, listas, janela; // Número de células e memória comum às estratégias.
+    long long grau; // Número de caixas empilháveis sobre uma caixa.
+    int i, w, c; // Variáveis auxiliares.
+
+    plano->empilhamentos = 0;
+    plano->transicoes = 0;
+    plano->valor_maximo = limite_valor(p);
+    plano->transicoes_valor = 0;
+    plano->menor_altura = plano->maior_altura = 0;
+    plano->limite = (limite > 0) ? limite : 0;
+    plano->escolhida = -1;
+
+    bits = (unsigned long long*) malloc(sizeof(unsigned long long) * (PALAVRAS_LINHA(p->n) + 1));
+    if (!bits)
+        return -1; // Falha, devido à ausência de recursos computacionais.
+
+    // Empilhamentos e transições, caixa a caixa, pela mesma comparação usada na construção das listas.
+    for(i = 0; i < p->n; i++) {
+        marca_empilhaveis(p->l, p->p, p->n, p->l[i], p->p[i], bits);
+        for(w = 0, grau = 0; w < PALAVRAS_LINHA(p->n); w++)
+            grau += __builtin_popcountll(bits[w]);
+
+        plano->empilhamentos += grau;
+        if (p->a[i] <= p->h) {
+            plano->transicoes += grau * (p->h - p->a[i] + 1);
+            if (plano->menor_altura == 0 || p->a[i] < plano->menor_altura)
+                plano->menor_altura = p->a[i];
+            if (p->a[i] > plano->maior_altura)
+                plano->maior_altura = p->a[i];
+            if (p->v[i] > 0 && p->v[i] < plano->valor_maximo)
+                plano->transicoes_valor += grau * (plano->valor_maximo - p->v[i]);
+        }
+    }
+    free(bits);
+
+    celulas = ((double) p->h + 1) * p->n;
+    celulas_valor = ((double) plano->valor_maximo + 1) * p->n;
+    listas = (double) p->n * (sizeof(lista) + sizeof(tipo_lista)) + (double) plano->empilhamentos * sizeof(tipo_nodo);
+    janela = ((double) plano->maior_altura + 1) * p->n * sizeof(int);
+
+    plano->estimativas[0].motor = MOTOR_BOTTOM_UP;
+    plano->estimativas[0].bytes = 2 * celulas * sizeof(int) + 2 * ((double) p->h + 1) * sizeof(int*) + listas;
+    plano->estimativas[0].bytes_disco = 0;
+    plano->estimativas[0].segundos = 2 * celulas * sizeof(int) * SEGUNDOS_POR_BYTE_TABELA +
+                                     (double) plano->transicoes * SEGUNDOS_POR_TRANSICAO;
+
+    plano->estimativas[1].motor = MOTOR_JANELA;
+    plano->estimativas[1].bytes = janela + celulas * largura_predecessor(p->n) + listas;
+    plano->estimativas[1].bytes_disco = 0;
+    plano->estimativas[1].segundos = (janela + celulas * largura_predecessor(p->n)) * SEGUNDOS_POR_BYTE_TABELA +
+                                     (double) plano->transicoes * SEGUNDOS_POR_TRANSICAO_JANELA;
+
+    plano->estimativas[2].motor = MOTOR_EXTERNO;
+    plano->estimativas[2].bytes = janela + (double) p->n * sizeof(int) + TAMANHO_BUFFER_ARQUIVO + listas;
+    plano->estimativas[2].bytes_disco = celulas * sizeof(int);
+    plano->estimativas[2].segundos = janela * SEGUNDOS_POR_BYTE_TABELA + celulas * sizeof(int) * SEGUNDOS_POR_BYTE_DISCO +
+                                     (double) plano->transicoes * SEGUNDOS_POR_TRANSICAO_JANELA;
+
+    plano->estimativas[3].motor = MOTOR_VALOR;
+    plano->estimativas[3].bytes = celulas_valor * sizeof(int) + listas;
+    plano->estimativas[3].bytes_disco = 0;
+    plano->estimativas[3].segundos = celulas_valor * sizeof(int) * SEGUNDOS_POR_BYTE_TABELA +
+                                     (double) plano->transicoes_valor * SEGUNDOS_POR_TRANSICAO;
+
+    // Escolhe a estratégia mais rápida dentre as que cabem no limite.
+    for(c = 0; c < NUM_CANDIDATOS_PLANO; c++) {
+        plano->estimativas[c].cabe = (plano->limite == 0 || plano->estimativas[c].bytes <= plano->limite);
+
+        if (plano->estimativas[c].cabe && (plano->escolhida == -1 ||
+                plano->estimativas[c].segundos < plano->estimativas[plano->escolhida].segundos))
+            plano->escolhida = c;
+    }
+
+    return (plano->escolhida != -1) ? plano->estimativas[plano->escolhida].motor : -1;
+} // fim da função planeja_resolucao
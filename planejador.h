@@ -0,0 +1,36 @@
+#ifndef PLANEJADOR_H_INCLUDED
+#define PLANEJADOR_H_INCLUDED
+
+#include "estruturas.h"
+
+/* Número de estratégias comparadas pelo planejador. */
+#define NUM_CANDIDATOS_PLANO 4
+
+/* Custos usados nas estimativas de tempo, medidos com as instâncias arquivos/stk*.data: */
+#define SEGUNDOS_POR_TRANSICAO 2.5e-9 // Exame de um empilhamento (caixa sobre caixa).
+#define SEGUNDOS_POR_TRANSICAO_JANELA 2.7e-9 // O mesmo, com os valores em uma janela circular.
+#define SEGUNDOS_POR_BYTE_TABELA 1.5e-9 // Primeira escrita de um byte das tabelas.
+#define SEGUNDOS_POR_BYTE_DISCO 4e-9 // Escrita sequencial e leitura de um byte em disco.
+
+typedef struct {
+    int motor; // Estratégia (uma das constantes MOTOR_* de empilhamento.h).
+    double bytes; // Memória estimada, em bytes.
+    double bytes_disco; // Espaço em disco estimado, em bytes.
+    double segundos; // Tempo estimado, em segundos.
+    int cabe; // Diferente de zero se a memória estimada não excede o limite.
+} estimativa_motor;
+
+typedef struct {
+    long long empilhamentos; // Pares de caixas (j sobre i) da relação de empilhamento.
+    long long transicoes; // Empilhamentos examinados pela programação dinâmica.
+    long long valor_maximo; // Limitante para o valor de uma pilha (linhas da estratégia indexada pelo valor).
+    long long transicoes_valor; // Empilhamentos examinados, no máximo, pela estratégia indexada pelo valor.
+    int menor_altura, maior_altura; // Alturas extremas das caixas que cabem na pilha.
+    double limite; // Limite de memória considerado, em bytes (0: sem limite).
+    estimativa_motor estimativas[NUM_CANDIDATOS_PLANO]; // Estimativas de cada estratégia.
+    int escolhida; // Índice da estratégia escolhida em estimativas (-1 se nenhuma cabe).
+} plano_resolucao;
+
+int planeja_resolucao(problema, double, plano_resolucao*);
+
+#endif // PLANEJADOR_H_INCLUDED
@@ -0,0 +1,132 @@
+#include <stdlib.h>
+#include "reducao.h"
+
+/* Redução de instâncias: etapa executada entre a leitura e a resolução do problema, que elimina
+ * caixas (rotações) que nunca são necessárias a uma solução ótima. São eliminadas:
+ *
+ *      - as caixas mais altas do que a altura máxima h, que não cabem em pilha alguma;
+ *      - as caixas de valor menor ou igual a 0 (zero): retirá-las de uma pilha não a torna
+ *        instável, não aumenta a sua altura e não diminui o seu valor;
+ *      - as caixas dominadas: uma caixa é dominada por outra de mesma base (mesmas largura e
+ *        profundidade) que não é mais alta e que não tem valor menor. Em qualquer pilha, a caixa
+ *        dominada pode ser trocada pela dominante, pois as caixas abaixo e acima continuam
+ *        compatíveis. Em particular, rotações idênticas (por exemplo, as duas rotações de uma
+ *        caixa de largura igual à altura) são unidas, prevalecendo a de maior valor.
+ *
+ * A solução ótima do problema reduzido tem o mesmo valor que a do problema original.
+ */
+
+/* Caixa (rotação) candidata, com o seu índice no problema original. */
+typedef struct {
+    caixa c; // Dimensões da caixa.
+    int v; // Valor da caixa.
+    int id; // Índice da caixa no problema original.
+} rotacao_candidata;
+
+
+/* Compara duas rotações, para ordenação com a função qsort: por base (largura e profundidade),
+ * depois por altura crescente e, por fim, por valor decrescente. */
+int compara_rotacao_base(const void* x, const void* y)
+{
+    const rotacao_candidata *r = (const rotacao_candidata*) x, *s = (const rotacao_candidata*) y;
+
+    if (r->c.l != s->c.l)
+        return (r->c.l < s->c.l) ? -1 : 1;
+    if (r->c.p != s->c.p)
+        return (r->c.p < s->c.p) ? -1 : 1;
+    if (r->c.a != s->c.a)
+        return (r->c.a < s->c.a) ? -1 : 1;
+    if (r->v != s->v)
+        return (r->v > s->v) ? -1 : 1;
+    return (r->id < s->id) ? -1 : (r->id > s->id);
+} // fim da função compara_rotacao_base
+
+
+/* Compara duas rotações pelo índice no problema original, para ordenação com a função qsort. */
+int compara_rotacao_id(const void* x, const void* y)
+{
+    const rotacao_candidata *r = (const rotacao_candidata*) x, *s = (const rotacao_candidata*) y;
+
+    return (r->id < s->id) ? -1 : (r->id > s->id);
+} // fim da função compara_rotacao_id
+
+
+/* Cria uma versão reduzida do problema p, conforme as regras descritas no início do arquivo.
+ * As caixas mantidas conservam a ordem relativa que tinham no problema original. Se todas as
+ * caixas forem eliminadas, a primeira é mantida, para que o problema reduzido não seja vazio.
+ *
+ * O parâmetro id_original, passado por referência, receberá um vetor (alocado dinamicamente)
+ * com o índice, no problema original, de cada caixa do problema reduzido. Os índices de uma
+ * pilha do problema reduzido são convertidos para o problema original por meio dele.
+ *
+ * Retorna o problema reduzido ou NULL, em caso de falha na alocação de memória. O problema
+ * original não é alterado.
+ *
+ * Obs.: É responsabilidade do utilizador desta função desalocar o problema reduzido (função
+ * termina_problema) e o vetor id_original.
+ *
+ * Complexidade: O(n log n)
+ */
+problema reduz_problema(problema p, int** id_original)
+{
+    rotacao_candidata *r; // Caixas candidatas.
+    problema q = NULL; // Problema reduzido.
+    int i, m = 0, maior_valor = 0; // Variáveis auxiliares.
+
+    *id_original = NULL;
+
+    r = (rotacao_candidata*) malloc(sizeof(rotacao_candidata) * p->n);
+    if (!r)
+        return NULL;
+
+    for(i = 0; i < p->n; i++) {
+        r[i].c = p->caixas[i];
+        r[i].v = p->v[i];
+        r[i].id = i;
+    }
+
+    // Após a ordenação, as caixas de mesma base ficam contíguas e em ordem crescente de altura.
+    // Uma caixa só é mantida se o seu valor superar o de todas as caixas de mesma base e de
+    // altura menor ou igual que a precedem, isto é, se não for dominada.
+    qsort(r, p->n, sizeof(rotacao_candidata), compara_rotacao_base);
+
+    for(i = 0; i < p->n; i++) {
+        if (i == 0 || r[i].c.l != r[i - 1].c.l || r[i].c.p != r[i - 1].c.p)
+            maior_valor = 0; // Início de um grupo de caixas de mesma base.
+
+        if (r[i].c.a <= p->h && r[i].v > maior_valor) {
+            maior_valor = r[i].v;
+            r[m++] = r[i]; // A caixa é mantida.
+        }
+    }
+
+    if (m == 0) { // Nenhuma caixa é útil: mantém-se a primeira.
+        r[0].c = p->caixas[0];
+        r[0].v = p->v[0];
+        r[0].id = 0;
+        m = 1;
+    }
+
+    // Restaura a ordem original das caixas mantidas.
+    qsort(r, m, sizeof(rotacao_candidata), compara_rotacao_id);
+
+    q = cria_problema(m, p->h);
+    *id_original = (int*) malloc(sizeof(int) * m);
+
+    if (q && *id_original) {
+        for(i = 0; i < m; i++) {
+            add_caixa(q, r[i].c);
+            add_valor(q, r[i].v);
+            (*id_original)[i] = r[i].id;
+        }
+    } else {
+        termina_problema(q);
+        free(*id_original);
+        *id_original = NULL;
+        q = NULL;
+    }
+
+    free(r);
+
+    return q; // Retorna o problema reduzido ou NULL.
+} // fim da função reduz_problema
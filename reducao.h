@@ -0,0 +1,8 @@
+#ifndef REDUCAO_H_INCLUDED
+#define REDUCAO_H_INCLUDED
+
+#include "estruturas.h"
+
+problema reduz_problema(problema, int**);
+
+#endif // REDUCAO_H_INCLUDED
@@ -0,0 +1,199 @@
+#include <stdlib.h>
+#include "valores.h"
+#include "grafo.h"
+#include "memoria.h"
+#include "perfil.h"
+
+/* Estratégia iterativa (bottom-up) indexada pelo valor acumulado, para alturas muito grandes com
+ * valores pequenos, em que a matriz (h + 1)n da estratégia iterativa é proibitiva.
+ *
+ * Em vez do maior valor de uma pilha de altura até k, a tabela guarda, para cada valor w e cada
+ * caixa i, a menor altura H(w, i) de uma pilha com base i e valor pelo menos w:
+ *
+ *      H(w, i) = a(i),                                         se v(i) >= w;
+ *      H(w, i) = a(i) + min { H(w - v(i), j) : j sobre i },    caso contrário.
+ *
+ * O valor ótimo é o maior w para o qual alguma caixa tem H(w, i) <= h. O número de linhas é
+ * limitado por W = floor(r·h), em que r é a melhor razão valor/altura das caixas (nenhuma pilha de
+ * altura h vale mais do que isso), e a resolução termina na primeira linha em que nenhuma caixa
+ * cabe na altura máxima, pois H(w, i) não decresce com w. Alturas maiores do que h são guardadas
+ * como h + 1. Caixas de valor nulo nunca reduzem a altura necessária para um valor e são ignoradas.
+ *
+ * A pilha é reconstruída sem matriz de predecessores: a caixa sobre i é qualquer j cuja altura
+ * H(w - v(i), j) seja exatamente H(w, i) - a(i).
+ *
+ * A memória utilizada é de (W + 1)n inteiros, e a estratégia é preferível à iterativa quando W < h.
+ */
+
+
+/* Retorna o limitante W = floor(r·h) para o valor de qualquer pilha do problema p, em que r é a
+ * melhor razão valor/altura dentre as caixas que cabem na altura máxima (0 se nenhuma cabe).
+ *
+ * Complexidade: O(n)
+ */
+long long limite_valor(problema p)
+{
+    long long limite = 0, candidato; // Limitante e o de cada caixa.
+    int i; // Variável auxiliar.
+
+    for(i = 0; i < p->n; i++)
+        if (p->caixas[i].a > 0 && p->caixas[i].a <= p->h && p->v[i] > 0) {
+            candidato = (long long) p->v[i] * p->h / p->caixas[i].a;
+            if (candidato > limite)
+                limite = candidato;
+        }
+
+    return limite;
+} // fim da função limite_valor
+
+
+/* Gera a pilha de caixas a partir da tabela de alturas mínimas (a linha w começa na posição w * n),
+ * para o valor w e a caixa da base informados. As listas de caixas empilháveis são as mesmas
+ * usadas no cálculo da tabela.
+ *
+ * Retorna o vetor com a pilha e o seu tamanho, ou NULL e o tamanho 0 (zero) em caso de falha na
+ * alocação de memória ou se a caixa da base for inválida.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n·w)
+ */
+int* reconstroi_pilha_valor(const int* tabela, lista* listas, problema p, int w, int base, int* tam)
+{
+    int *vetor, alvo, j; // Vetor que será retornado pela função e variáveis auxiliares.
+    tipo_nodo *no; // Variável auxiliar utilizada para percorrer a lista de caixas empilháveis.
+
+    *tam = 0; // O tamanho da pilha é inicializado com 0 (zero).
+
+    if (base < 0 || base >= p->n || w <= 0) // Verifica se o subproblema é válido.
+        return NULL;
+
+    vetor = (int*) malloc(sizeof(int) * w); // Cada caixa da pilha vale pelo menos 1 (um).
+
+    while (vetor && base != -1) {
+        vetor[(*tam)++] = base; // Insere a caixa na pilha.
+
+        if (p->v[base] >= w) // A caixa sozinha alcança o valor restante.
+            break;
+
+        // A caixa empilhada sobre ela completa a altura mínima da célula (w, base).
+        alvo = tabela[(long long) w * p->n + base] - p->caixas[base].a;
+        w = w - p->v[base];
+
+        for(no = listas[base]->first, j = -1; no && j == -1; no = no->next)
+            if (tabela[(long long) w * p->n + no->item.chave] == alvo)
+                j = no->item.chave;
+
+        base = j;
+    }
+
+    return vetor; // Retorna o vetor criado ou NULL.
+} // fim da função reconstroi_pilha_valor
+
+
+/* Encontra a solução ótima para o problema de empilhamento de caixas, utilizando a estratégia
+ * indexada pelo valor descrita no início do arquivo.
+ *
+ * Os parâmetros e os valores de retorno são os mesmos da função empilhamento_bottom_up.
+ *
+ * Obs.: A função cria e retorna um vetor alocado dinamicamente. É responsabilidade do utilizador
+ * desta função desalocá-lo posteriormente.
+ *
+ * Complexidade: O(n²W), em que W = floor(r·h) (ver limite_valor).
+ */
+int empilhamento_por_valor(problema p, int** vetor_de_caixas_empilhadas, int* tam)
+{
+    int *tabela = NULL, *atual, *anterior; // Tabela de alturas mínimas e linhas em uso.
+    int w, i, j, pos, cancelada = 0, base = -1, solucao_otima = -1, infinito = p->h + 1; // Variáveis auxiliares.
+    long long limite = limite_valor(p); // Número de linhas da tabela, além da linha 0 (zero).
+    lista *vetor_lista_de_caixas_empilhaveis; // Listas de caixas empilháveis.
+    tipo_nodo *no; // Variável auxiliar utilizada para percorrer a lista de caixas empilháveis.
+
+    // Verifica se a variável passada como parâmetro representa memória alocada.
+    if (*vetor_de_caixas_empilhadas)
+        free(*vetor_de_caixas_empilhadas); // Libera a memória alocada.
+
+    *vetor_de_caixas_empilhadas = NULL; // Inicialização das variáveis passadas por
+    *tam = 0;                           // referência e que retornarão valores também.
+
+    p->est.subproblemas = 0; // Zera os contadores
+    p->est.transicoes = 0;   // de esforço computacional.
+
+    vetor_lista_de_caixas_empilhaveis = cria_vetor_lista_de_caixas_empilhaveis(p);
+    if (vetor_lista_de_caixas_empilhaveis)
+        tabela = (int*) aloca_tabela(sizeof(int) * (size_t) (limite + 1) * p->n, &p->est.tipo_paginas);
+
+    if (tabela && vetor_lista_de_caixas_empilhaveis) {
+
+        // A linha 0 (zero) tem solução conhecida: nenhuma caixa, de altura 0 (zero).
+        inicia_fase(p, FASE_PROGRAMACAO);
+        for(i = 0; i < p->n; i++)
+            tabela[i] = 0;
+
+        solucao_otima = 0;
+
+        // Cada linha depende apenas das anteriores, pois toda caixa considerada tem valor positivo.
+        for(w = 1; w <= limite && solucao_otima == w - 1 && !cancelada; w++) {
+
+            atual = tabela + (long long) w * p->n; // Linha w da tabela.
+            pos = -1; // Base da pilha mais baixa de valor w que cabe na altura máxima.
+
+            for(i = 0; i < p->n; i++) {
+                atual[i] = infinito;
+
+                if (p->v[i] > 0 && p->caixas[i].a <= p->h) {
+
+                    p->est.subproblemas++;
+
+                    if (p->v[i] >= w) // A caixa sozinha alcança o valor w.
+                        atual[i] = p->caixas[i].a;
+                    else {
+                        p->est.transicoes += vetor_lista_de_caixas_empilhaveis[i]->tamanho;
+
+                        anterior = tabela + (long long) (w - p->v[i]) * p->n; // Linha w - v(i).
+
+                        // A comparação com atual[i] - a(i) evita o estouro da soma das alturas.
+                        for(no = vetor_lista_de_caixas_empilhaveis[i]->first; no; no = no->next) {
+                            j = no->item.chave;
+                            if (anterior[j] < atual[i] - p->caixas[i].a)
+                                atual[i] = anterior[j] + p->caixas[i].a;
+                        }
+                    }
+
+                    if (atual[i] <= p->h && (pos == -1 || atual[i] < atual[pos]))
+                        pos = i;
+                }
+            }
+
+            if (pos != -1) { // Alguma pilha de valor w cabe na altura máxima.
+                solucao_otima = w;
+                base = pos;
+            }
+
+            // A cada INTERVALO_CONTROLE linhas, informa o progresso e verifica se houve pedido de cancelamento.
+            if (w % INTERVALO_CONTROLE == 0 || w == limite)
+                cancelada = acompanha_resolucao(p, w, limite);
+        }
+        encerra_fase(p, FASE_PROGRAMACAO);
+
+        if (cancelada && solucao_otima == w - 1 && w <= limite) // Resolução interrompida: não há solução.
+            solucao_otima = RESOLUCAO_CANCELADA;
+        else if (solucao_otima > 0) { // Se a variável é maior do que 0 (zero), uma solução ótima foi encontrada.
+            inicia_fase(p, FASE_RECONSTRUCAO);
+            (*vetor_de_caixas_empilhadas) = reconstroi_pilha_valor(tabela, vetor_lista_de_caixas_empilhaveis, p,
+                                                                   solucao_otima, base, tam);
+            encerra_fase(p, FASE_RECONSTRUCAO);
+
+            if (!(*vetor_de_caixas_empilhadas)) // Verifica se a alocação foi bem sucedida.
+                solucao_otima = -1; // Falha, devido à ausência de recursos computacionais.
+        }
+    }
+
+    // Libera todos os recursos alocados.
+    if (vetor_lista_de_caixas_empilhaveis)
+        termina_vetor_lista_de_caixas_empilhaveis(vetor_lista_de_caixas_empilhaveis, p->n);
+    libera_tabela(tabela);
+
+    return solucao_otima; // Retorna a solução ótima ou -1, em caso de falha na alocação de memória.
+} // fim da função empilhamento_por_valor
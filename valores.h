@@ -0,0 +1,12 @@
+#ifndef VALORES_H_INCLUDED
+#define VALORES_H_INCLUDED
+
+#include "estruturas.h"
+
+long long limite_valor(problema);
+
+int* reconstroi_pilha_valor(const int*, lista*, problema, int, int, int*);
+
+int empilhamento_por_valor(problema, int**, int*);
+
+#endif // VALORES_H_INCLUDED